@@ -92,8 +92,13 @@ inline int socket_init(void) {
 
 #ifdef _LINUX
 
-#define socket_init() 0
-#define socket_cleanup() 0
+inline int socket_init(void) {
+    return 0;
+}
+
+inline int socket_cleanup(void) {
+    return 0;
+}
 
 inline int _close(socket_t fd){
     close(fd);
@@ -5,12 +5,19 @@
 #include "HTTP/HTTP_StatusLine.hpp"
 #include "HTTP/HTTP_Cookie.hpp"
 #include "HTTP/HTTP_Header.hpp"
+#include "HTTP/HTTP_Date.hpp"
 
 #include "HTTP/HTTP_Request.hpp"
+#include "HTTP/HTTP_RequestView.hpp"
+#include "HTTP/HTTP_ChunkedDecoder.hpp"
+#include "HTTP/HTTP_RequestParser.hpp"
 #include "HTTP/HTTP_Response.hpp"
+#include "HTTP/HTTP_ResponseParser.hpp"
 
+#include "HTTP/HTTP_ConnectionPool.hpp"
 #include "HTTP/HTTP_Session.hpp"
 
 #include "HTTP/HTTP_Client.hpp"
+#include "HTTP/HTTP_AsyncClient.hpp"
 
 #endif // __HTTP_HPP__
\ No newline at end of file
@@ -0,0 +1,194 @@
+#ifndef __HTTP_ASYNC_CLIENT_HPP__
+#define __HTTP_ASYNC_CLIENT_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "EzNet/Utility/Network/URL.hpp"
+#include "HTTP_ConnectionPool.hpp"
+#include "HTTP_Request.hpp"
+#include "HTTP_Response.hpp"
+#include "HTTP_ResponseParser.hpp"
+
+namespace tab {
+
+// Implemented in HTTP_AsyncClient.cpp
+class AsyncConnection;
+
+/**
+ * @brief An event loop running in a thread of its own, which drives the
+ *        requests of the 'HttpAsyncClient's sharing it. No thread is
+ *        needed for each request.
+ *
+ * The idle keep-alive connections are kept in the loop, so the clients
+ * sharing it share them too.
+ *
+ * @note It is built on epoll, so it is only available on Linux.
+ */
+class HttpEventLoop {
+public:
+    /**
+     * @brief Start the thread of the loop.
+     *
+     * @throw std::runtime_error if the loop can not be created.
+     */
+    HttpEventLoop();
+
+    HttpEventLoop(const HttpEventLoop&) = delete;
+    HttpEventLoop& operator=(const HttpEventLoop&) = delete;
+
+    // Stop the loop.
+    ~HttpEventLoop();
+
+    /**
+     * @brief Run 'task' in the thread of the loop, it is thread-safe.
+     *        If the loop has stopped, it runs in the calling thread.
+     */
+    void post(std::function<void()> task);
+
+    /**
+     * @brief Stop the loop and wait for its thread. The requests which are
+     *        not finished fail.
+     *
+     * @warning Do not call it (or destroy the loop) in the thread of the
+     *          loop, such as in the callbacks of the requests.
+     */
+    void stop();
+
+    bool inLoopThread() const noexcept {
+        return std::this_thread::get_id() == thread_.get_id();
+    }
+
+private:
+    friend class AsyncConnection;
+    friend class HttpAsyncClient;
+
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+    // Watch the connection for 'events' (of epoll), in the loop thread.
+    void watch(AsyncConnection* conn, uint32_t events);
+    void setDeadline(AsyncConnection* conn, int milliseconds);
+    void cancelDeadline(AsyncConnection* conn);
+    int  nextTimeout();
+    void expire();
+    // Borrow an idle connection, or null if there is none.
+    AsyncConnection* acquire(const HttpConnectionPool::Key& key);
+    void release(AsyncConnection* conn, size_t max_idle);
+    // Close the connection, which must not be in use.
+    void destroy(AsyncConnection* conn);
+    // 'destroy()' of a connection which has been taken out of 'idle_'.
+    void close(AsyncConnection* conn);
+
+    int epfd_    = -1;
+    int wake_fd_ = -1;
+    std::atomic<bool> running_{ false };
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::vector<std::function<void()>> tasks_;
+    // Whether the thread has exited, guarded by 'mutex_'.
+    bool stopped_ = false;
+
+    // The members below are only used in the loop thread.
+    std::unordered_set<AsyncConnection*> connections_;
+    std::multimap<Clock::time_point, AsyncConnection*> deadlines_;
+    std::map<HttpConnectionPool::Key, std::vector<AsyncConnection*>> idle_;
+    // Deleted after the events being handled, which may refer to them.
+    std::vector<AsyncConnection*> closed_;
+    // Where the data received is read into.
+    std::unique_ptr<char[]> buffer_;
+
+}; // class HttpEventLoop
+
+
+/**
+ * @brief A client whose requests do not block the calling thread. They
+ *        are driven by an 'HttpEventLoop', which may be shared with other
+ *        clients.
+ *
+ * The connections are kept alive and used again like 'HttpClient' does.
+ * Only "http" is supported.
+ */
+class HttpAsyncClient {
+public:
+    /**
+     * @brief Called in the thread of the loop when the request finishes.
+     *        If 'error' is not null, the request failed, and 'response'
+     *        is empty.
+     *
+     * @note It must not block, since it blocks all the requests of the
+     *       loop.
+     */
+    using Callback = std::function<void(std::exception_ptr error,
+                                        HttpResponse& response)>;
+
+    struct Options {
+        // Of a whole request, from connecting to the end of the response,
+        // 0 for no limit.
+        int    timeout_milliseconds = 30000;
+        // Idle connections kept for each (scheme, host, port).
+        size_t max_idle_per_host = 8;
+        HttpResponseParser::Limits limits;
+    };
+
+public:
+    /**
+     * @brief Construct a client with a loop of its own.
+     */
+    HttpAsyncClient();
+
+    /**
+     * @brief Construct a client driven by 'loop'.
+     */
+    HttpAsyncClient(std::shared_ptr<HttpEventLoop> loop);
+
+    HttpAsyncClient(std::shared_ptr<HttpEventLoop> loop, const Options& opt);
+
+    /**
+     * @brief Send 'request' to 'url', whose path and host name are set to
+     *        the URI and the "Host" of the request.
+     *
+     * @note The host name is resolved in the calling thread.
+     */
+    void request(const URL& url, HttpRequest request, Callback callback);
+
+    /**
+     * @brief Send 'request' to 'url', and get the response from the future.
+     */
+    std::future<HttpResponse> request(const URL& url, HttpRequest request);
+
+    /**
+     * @brief Send a "GET" request to 'url'.
+     */
+    std::future<HttpResponse> get(const URL& url) {
+        return request(url, HttpRequest(HTTP::REQ_GET, "/"));
+    }
+
+    Options& options() noexcept {
+        return options_;
+    }
+
+    std::shared_ptr<HttpEventLoop> getLoop() const noexcept {
+        return loop_;
+    }
+
+private:
+    std::shared_ptr<HttpEventLoop> loop_;
+    Options options_;
+
+}; // class HttpAsyncClient
+
+} // namespace tab
+
+#endif // __HTTP_ASYNC_CLIENT_HPP__
@@ -0,0 +1,110 @@
+#ifndef __HTTP_CHUNKED_DECODER_HPP__
+#define __HTTP_CHUNKED_DECODER_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace tab {
+
+/**
+ * @brief A streaming decoder of the chunked transfer coding.
+ *
+ * It can be fed with the data in pieces of any size, and the payload of
+ * the chunks is passed to the sink as spans of the fed data, so nothing
+ * is copied but the lines split across the pieces. The chunk extensions
+ * are skipped, and the trailer fields are passed to the trailer handler
+ * if there is one.
+ */
+class ChunkedDecoder {
+public:
+    enum class Status {
+        NEED_MORE, // the last chunk and the trailer have not been decoded
+        COMPLETE,  // the whole body has been decoded
+        INVALID,   // syntax error
+        TOO_LARGE  // the body or the trailer exceeds the limit
+    };
+
+    using Sink = std::function<void(const char*, size_t)>;
+
+public:
+    ChunkedDecoder() { }
+
+    /**
+     * @brief Decode the data following the ones fed before, and pass
+     *        the payload to 'sink'.
+     *
+     * @param consumed Set to the number of bytes used. It is less than
+     *                 'len' only if the body ends before the end of the
+     *                 data.
+     *
+     * @note After COMPLETE, INVALID or TOO_LARGE, call 'reset()' before
+     *       decoding the next body.
+     */
+    Status decode(const char* data, size_t len, size_t& consumed,
+                  const Sink& sink);
+
+    /**
+     * @brief Receive the trailer fields, such as "Name: value".
+     */
+    void setTrailerHandler(std::function<void(std::string_view)> h) {
+        trailer_handler_ = std::move(h);
+    }
+
+    // Limit the total size of the payload, 0 for no limit.
+    void setMaxBodySize(size_t size) noexcept {
+        max_body_size_ = size;
+    }
+
+    // Limit the total size of the trailer fields.
+    void setMaxTrailerSize(size_t size) noexcept {
+        max_trailer_size_ = size;
+    }
+
+    // Bytes of the payload decoded.
+    size_t bodySize() const noexcept {
+        return body_size_;
+    }
+
+    /**
+     * @brief Prepare for the next body, the limits and the trailer
+     *        handler are kept.
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Whether the last transfer coding of a "Transfer-Encoding" 
+     *        value, such as "gzip, chunked", is "chunked", which means the 
+     *        body is decoded by this.
+     */
+    static bool IsChunked(std::string_view transfer_encoding) noexcept;
+
+private:
+    enum class State {
+        SIZE,       // the line of the size of a chunk
+        DATA,       // the payload of a chunk
+        DATA_END,   // the CRLF after the payload
+        TRAILER,    // the trailer fields after the last chunk
+        DONE
+    };
+
+    bool   takeLine(const char*& p, const char* end, std::string_view& line);
+    Status onSizeLine(std::string_view line);
+
+    State  state_ = State::SIZE;
+    size_t remaining_ = 0;
+    size_t body_size_ = 0;
+    size_t trailer_size_ = 0;
+    size_t max_body_size_ = 0;
+    size_t max_trailer_size_ = 65536;
+    // The part of a line received before.
+    std::string line_;
+    bool        line_taken_ = false;
+    std::function<void(std::string_view)> trailer_handler_;
+
+}; // class ChunkedDecoder
+
+} // namespace tab
+
+#endif // __HTTP_CHUNKED_DECODER_HPP__
@@ -1,10 +1,12 @@
 #ifndef __HTTP_CLIENT_HPP__
 #define __HTTP_CLIENT_HPP__
 
+#include <memory>
 #include <utility>
 
 #include "EzNet/Socket/StreamSocket.hpp"
 #include "EzNet/Socket/SecureSocket.hpp"
+#include "EzNet/HTTP/HTTP_ConnectionPool.hpp"
 #include "EzNet/HTTP/HTTP_Session.hpp"
 #include "EzNet/Utility/Network/URL.hpp"
 
@@ -15,9 +17,14 @@ public:
     /**
      * @brief Construct a new Http Client object
      */
-    HttpClient(void) {
-        // addSocket(ip);
-    }
+    HttpClient(void) : pool_(std::make_shared<HttpConnectionPool>()) { }
+
+    /**
+     * @brief Construct a new Http Client object with the options of
+     *        its connection pool.
+     */
+    HttpClient(const HttpConnectionPool::Options& opt) : 
+        pool_(std::make_shared<HttpConnectionPool>(opt)) { }
     
     /**
      * @brief Construct a new HttpClient object(move)
@@ -35,7 +42,8 @@ public:
     /**
      * @brief Move a HttpClient object
      */
-    HttpClient& operator=(HttpClient&&) noexcept {
+    HttpClient& operator=(HttpClient&& client) noexcept {
+        pool_.swap(client.pool_);
         return *this;
     }
 
@@ -43,7 +51,8 @@ public:
     /**
      * @brief Swap with the given HttpClient
      */
-    HttpClient& swap(HttpClient&) noexcept {
+    HttpClient& swap(HttpClient& client) noexcept {
+        pool_.swap(client.pool_);
         return *this;
     }
 
@@ -53,11 +62,23 @@ public:
      * 
      * @param url The target
      * @return HttpSessionClient
+     * 
+     * @note The session borrows the idle connections of this client, and
+     * @note returns its connection when it is destroyed or its target
+     * @note host is changed.
      */
     HttpSessionClient target(const URL& url);
 
+    /**
+     * @brief Get the pool of the idle connections, shared by the sessions.
+     */
+    HttpConnectionPool& getPool(void) noexcept {
+        return *pool_;
+    }
+
 protected:
-    // EMPTY
+    // Shared with the sessions, which may outlive this client.
+    std::shared_ptr<HttpConnectionPool> pool_;
 
 }; // class HttpClient
 
@@ -0,0 +1,115 @@
+#ifndef __HTTP_CONNECTION_POOL_HPP__
+#define __HTTP_CONNECTION_POOL_HPP__
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "EzNet/Socket/Socket.hpp"
+#include "EzNet/Utility/Network/URL.hpp"
+
+namespace tab {
+
+/**
+ * @brief A thread-safe pool of idle keep-alive connections, which are
+ *        kept by (scheme, host, port).
+ *
+ * 'HttpClient' owns one, and the sessions made by it borrow connections
+ * from the pool and return them when they are done with the target, so
+ * the requests to the same server need not connect (and handshake) again.
+ */
+class HttpConnectionPool {
+public:
+    struct Key {
+        URL::Protocol protocol = URL::Protocol::HTTP;
+        std::string   host;
+        port_t        port = 0;
+
+        Key() { }
+        Key(const URL& url) :
+            protocol(url.getProtocol()),
+            host(url.getHostName()),
+            port(url.getPort()) { }
+
+        bool operator<(const Key& k) const noexcept {
+            return std::tie(protocol, host, port) <
+                   std::tie(k.protocol, k.host, k.port);
+        }
+    };
+
+    struct Options {
+        // Idle connections kept for each key, the others are closed.
+        size_t max_per_host = 8;
+        // Idle connections older than this are closed.
+        int    idle_timeout_seconds = 60;
+    };
+
+public:
+    HttpConnectionPool() { }
+    HttpConnectionPool(const Options& opt) : options_(opt) { }
+
+    HttpConnectionPool(const HttpConnectionPool&) = delete;
+    HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+    /**
+     * @brief Borrow an idle connection to 'key'.
+     *
+     * @return The connection used most recently, or null if there is none.
+     *
+     * @note The connections expired, closed by the peer, or having
+     *       unexpected data to read are dropped instead of being returned.
+     */
+    std::shared_ptr<Socket> acquire(const Key& key);
+
+    /**
+     * @brief Return a connection, which must have finished its last
+     *        response, to the pool.
+     */
+    void release(const Key& key, std::shared_ptr<Socket> socket);
+
+    // Close the idle connections expired.
+    void purge();
+
+    // Close all the idle connections.
+    void clear();
+
+    size_t idleCount() const;
+    size_t idleCount(const Key& key) const;
+
+    Options getOptions() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return options_;
+    }
+
+    void setOptions(const Options& opt) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_ = opt;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Idle {
+        std::shared_ptr<Socket> socket;
+        Clock::time_point       since;
+    };
+
+    // The oldest first.
+    using IdleList = std::deque<Idle>;
+
+    void purgeLocked(Clock::time_point now,
+                     std::deque<std::shared_ptr<Socket>>& dropped);
+
+    mutable std::mutex       mutex_;
+    Options                  options_;
+    std::map<Key, IdleList>  idle_;
+
+}; // class HttpConnectionPool
+
+} // namespace tab
+
+#endif // __HTTP_CONNECTION_POOL_HPP__
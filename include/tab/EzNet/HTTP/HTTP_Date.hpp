@@ -0,0 +1,44 @@
+#ifndef __HTTP_DATE_HPP__
+#define __HTTP_DATE_HPP__
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+
+namespace tab {
+
+namespace HTTP {
+
+// Length of an HTTP-date, such as "Sun, 06 Nov 1994 08:49:37 GMT".
+constexpr size_t DATE_LENGTH = 29;
+
+/**
+ * @brief Write 'time' as an HTTP-date (the IMF-fixdate of RFC 9110), 
+ *        such as "Sun, 06 Nov 1994 08:49:37 GMT", to 'out', which must 
+ *        have 'DATE_LENGTH' bytes. No null character is written.
+ *
+ * @note It does not depend on the locale.
+ */
+void FormatDate(std::time_t time, char* out) noexcept;
+
+inline std::string FormatDate(std::time_t time) {
+    char buf[DATE_LENGTH];
+    FormatDate(time, buf);
+    return std::string(buf, DATE_LENGTH);
+}
+
+/**
+ * @brief The current time as an HTTP-date of 'DATE_LENGTH' bytes (not 
+ *        null-terminated), for the "Date" of the responses.
+ *
+ * @note Each thread keeps its own copy, which is formatted again only 
+ *       when the second changes. It is valid until the next call in the 
+ *       same thread.
+ */
+const char* CurrentDate() noexcept;
+
+} // namespace HTTP
+
+} // namespace tab
+
+#endif // __HTTP_DATE_HPP__
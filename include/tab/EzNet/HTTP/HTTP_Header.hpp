@@ -2,13 +2,16 @@
 #define __HTTP_HEADER_HPP__
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <exception>
 #include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "EzNet/Utility/General/Exceptions.hpp"
 #include "HTTP_Cookie.hpp"
@@ -127,7 +130,18 @@ enum HeaderFieldName {
  * 
  * @note Defined in HTTP_Header.cpp
  */
-extern const char* HeaderKeyName[];
+extern const char* const HeaderKeyName[];
+
+/**
+ * @brief Get the 'HeaderFieldName' of a header name, which is compared 
+ *        case-insensitively, so "content-length" is 'CONTENT_LENGTH' too.
+ * 
+ * @return NONE if it is not one of 'HeaderKeyName'.
+ * 
+ * @note It takes constant time, by a perfect hash table generated 
+ *       at compile time.
+ */
+HeaderFieldName HeaderFieldStringToEnum(std::string_view name) noexcept;
 
 /**
  * @warning This interface is not recommended to use directly.
@@ -417,43 +431,56 @@ private:
 
 /**
  * @brief A set of 'Header's.
+ * 
+ * The fields are kept in a flat array in the order they are added, and 
+ * the first 'INLINE_CAPACITY' ones are stored inside the object. The 
+ * common headers are indexed by 'HeaderFieldName' as well, so they are 
+ * found without any comparison. The strings of a removed field keep 
+ * their memory for the fields added later.
  */
 class Headers {
+public:
+    constexpr static size_t INLINE_CAPACITY = 16;
+
 public:
     Headers(void) = default;
 
     Headers(const Headers&) = default;
 
-    Headers(Headers&& val) noexcept:
-        map_common_(std::move(val.map_common_)),
-        map_unknown_(std::move(val.map_unknown_)) { }
+    Headers(Headers&& val) noexcept {
+        *this = std::move(val);
+    }
 
     size_t size(void) const noexcept{
-        return map_common_.size() + map_unknown_.size();
+        return count_;
     }
 
     std::string& operator[](HeaderFieldName key) {
-        return map_common_.operator[](key);
+        return valueOf(key);
     }
 
-    Headers& operator=(const Headers& val) {
-        map_common_ = val.map_common_;
-        map_unknown_ = val.map_unknown_;
-        return *this;
-    }
+    Headers& operator=(const Headers& val) = default;
 
-    Headers& operator=(Headers&& val) {
-        map_common_ = std::move(val.map_common_);
-        map_unknown_ = std::move(val.map_unknown_);
-        return *this;
-    }
+    Headers& operator=(Headers&& val) noexcept;
 
     std::string getStr(void) const;
 
+    /**
+     * @brief Append the fields to 'out', which is the same as 
+     *        'out.append(getStr())' without the temporary string.
+     */
+    void appendTo(std::string& out) const;
+
     Headers& addHeader(const Header& header);
     Headers& addHeader(Header&& header);
     Headers& addHeader(HeaderFieldName key, const std::string& value);
     Headers& addHeader(const std::string& key, const std::string& value);
+
+    /**
+     * @brief Parse a line like "Name: value" and add it, 
+     *        which is the same as 'addHeader(Header::parse(raw, len))'.
+     */
+    Headers& addField(const char* raw, size_t len);
     
     /**
      * @brief It's same as addHeader().
@@ -480,13 +507,48 @@ public:
     std::string find(HeaderFieldName key);
     std::string find(const std::string& key);
 
+    /**
+     * @brief Whether the common header is present, without copying its 
+     *        value like 'find()' does.
+     */
+    bool contains(HeaderFieldName key) const noexcept {
+        return key != NONE && slots_[key] != 0;
+    }
+
     Headers& remove(const HeaderFieldName& key);
     Headers& remove(const std::string& key);
     
 private: 
-    // Holds all the keys and values.
-    std::map<HeaderFieldName, std::string> map_common_;
-    std::map<std::string, std::string> map_unknown_;
+    struct Field {
+        HeaderFieldName key = NONE;
+        std::string     name;   // used if 'key' is NONE
+        std::string     value;
+    };
+
+    Field& at(size_t i) noexcept {
+        return i < INLINE_CAPACITY ? inline_[i] : more_[i - INLINE_CAPACITY];
+    }
+
+    const Field& at(size_t i) const noexcept {
+        return i < INLINE_CAPACITY ? inline_[i] : more_[i - INLINE_CAPACITY];
+    }
+
+    // Get the value of the field, which is added if it does not exist.
+    std::string& valueOf(HeaderFieldName key);
+    std::string& valueOf(std::string_view name);
+
+    // Index of the field of an unknown header, or 'count_'.
+    size_t indexOf(std::string_view name) const noexcept;
+
+    Field& append(HeaderFieldName key);
+    void erase(size_t i);
+
+    Field              inline_[INLINE_CAPACITY];
+    // The fields after the inline ones.
+    std::vector<Field> more_;
+    size_t             count_ = 0;
+    // Index + 1 of the field of each common header, 0 if it is absent.
+    uint16_t           slots_[WWW_AUTHENTICATE + 1] = {};
 
 }; // class Headers
 
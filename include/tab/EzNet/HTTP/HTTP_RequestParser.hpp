@@ -0,0 +1,127 @@
+#ifndef __HTTP_REQUEST_PARSER_HPP__
+#define __HTTP_REQUEST_PARSER_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "HTTP_ChunkedDecoder.hpp"
+#include "HTTP_RequestView.hpp"
+
+namespace tab {
+
+/**
+ * @brief An incremental request parser, which can be fed with the data
+ *        of a connection in pieces of any size.
+ *
+ * It keeps the state between the calls of 'feed()', so a request split
+ * across several reads is parsed without parsing its head again, and
+ * the body can be larger than the receiving buffer. Both bodies with
+ * 'Content-Length' and chunked ones (the chunk extensions and the
+ * trailer fields are skipped) are supported.
+ *
+ * If a whole request is fed at once, nothing is copied and 'request()'
+ * refers to the fed data. Otherwise the head and the body are collected
+ * inside the parser.
+ */
+class HttpRequestParser {
+public:
+    enum class Status {
+        NEED_MORE, // the request is not complete yet
+        COMPLETE,  // 'request()' is ready
+        INVALID,   // syntax error
+        TOO_LARGE  // the head or the body exceeds the limit
+    };
+
+    struct Limits {
+        size_t max_head_size = 65536;
+        size_t max_body_size = 8 * 1024 * 1024;
+    };
+
+public:
+    HttpRequestParser() { }
+    HttpRequestParser(const Limits& l) : limits_(l) { }
+
+    /**
+     * @brief Parse the data following the ones fed before.
+     *
+     * @param consumed Set to the number of bytes used. It is less than
+     *                 'len' only if the request completes before the end
+     *                 of the data, and the rest belongs to the next one.
+     *
+     * @note After COMPLETE, INVALID or TOO_LARGE, call 'reset()' before
+     *       feeding the next request.
+     */
+    Status feed(const char* data, size_t len, size_t& consumed);
+
+    Status feed(std::string_view data, size_t& consumed) {
+        return feed(data.data(), data.size(), consumed);
+    }
+
+    /**
+     * @brief Get the request parsed, valid after COMPLETE.
+     *
+     * @note If the request was fed at once, it refers to the fed data.
+     */
+    const HttpRequestView& request() const noexcept {
+        return view_;
+    }
+
+    /**
+     * @brief Pass the body to 'sink' piece by piece instead of collecting
+     *        it, so large bodies need not be kept in memory.
+     *        The body of 'request()' is empty then.
+     */
+    void setBodySink(std::function<void(const char*, size_t)> sink) {
+        sink_ = std::move(sink);
+    }
+
+    Limits& limits() noexcept {
+        return limits_;
+    }
+
+    // Whether a part of the next request has been fed.
+    bool started() const noexcept {
+        return state_ != State::HEAD || !head_.empty();
+    }
+
+    /**
+     * @brief Prepare for the next request, the memory allocated is kept.
+     */
+    void reset() noexcept;
+
+private:
+    enum class State {
+        HEAD,          // the request line and the header fields
+        BODY,          // the body with 'Content-Length'
+        CHUNKED,       // the chunked body, see 'ChunkedDecoder'
+        DONE
+    };
+
+    Status parseHead(const char*& p, const char* end);
+    Status startBody();
+    void   emitBody(const char* p, size_t n);
+    void   keepHead();
+
+    Limits         limits_;
+    State          state_ = State::HEAD;
+    HttpRequestView view_;
+    // The head collected, empty if it is parsed in the fed data.
+    std::string    head_;
+    // Where to continue searching the end of the head in 'head_'.
+    size_t         head_scan_ = 0;
+    // Whether 'view_' refers to the data being fed.
+    bool           in_place_ = false;
+    std::string    body_;
+    size_t         body_size_ = 0;
+    // Bytes left of the body.
+    size_t         remaining_ = 0;
+    ChunkedDecoder chunked_;
+    std::function<void(const char*, size_t)> sink_;
+
+}; // class HttpRequestParser
+
+} // namespace tab
+
+#endif // __HTTP_REQUEST_PARSER_HPP__
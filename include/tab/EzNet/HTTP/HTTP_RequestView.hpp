@@ -0,0 +1,163 @@
+#ifndef __HTTP_REQUEST_VIEW_HPP__
+#define __HTTP_REQUEST_VIEW_HPP__
+
+#include <cstddef>
+#include <string_view>
+
+#include "HTTP_RequestLine.hpp"
+#include "HTTP_Header.hpp"
+#include "HTTP_Request.hpp"
+
+namespace tab {
+
+namespace HTTP {
+
+/**
+ * @brief A header field referring to the parsed data.
+ */
+struct HeaderView {
+    std::string_view name;
+    std::string_view value;
+};
+
+} // namespace HTTP
+
+
+/**
+ * @brief A request parsed in place.
+ *
+ * Unlike 'HttpRequest', it does not copy anything: the URI, the version,
+ * the header fields and the body all refer to the parsed data, and the
+ * header fields are stored in a fixed array inside the object. So parsing
+ * a request allocates no memory, and the view is valid only as long as
+ * the parsed data is.
+ */
+class HttpRequestView {
+public:
+    // Maximum number of the header fields of a request.
+    constexpr static size_t MAX_HEADERS = 64;
+
+    enum class ParseStatus {
+        OK,         // the whole head has been parsed
+        INCOMPLETE, // more data are needed
+        INVALID     // syntax error, or too many header fields
+    };
+
+public:
+    HttpRequestView() { }
+
+    /**
+     * @brief Parse the request at the beginning of 'raw'.
+     *
+     * The body is the following 'Content-Length' bytes (or the ones
+     * available, if the data are not complete). Without the header,
+     * the request has no body, unless 'Transfer-Encoding' is present,
+     * in which case all the remaining data are taken as the body.
+     */
+    ParseStatus parse(const char* raw, size_t len);
+
+    ParseStatus parse(std::string_view raw) {
+        return parse(raw.data(), raw.size());
+    }
+
+    HTTP::ReqMethod getMethod() const noexcept {
+        return method_;
+    }
+
+    std::string_view getMethodName() const noexcept {
+        return method_name_;
+    }
+
+    std::string_view getURI() const noexcept {
+        return uri_;
+    }
+
+    // Such as "1.1", without the leading "HTTP/".
+    std::string_view getVersion() const noexcept {
+        return version_;
+    }
+
+    size_t headerCount() const noexcept {
+        return header_count_;
+    }
+
+    const HTTP::HeaderView* begin() const noexcept {
+        return headers_;
+    }
+
+    const HTTP::HeaderView* end() const noexcept {
+        return headers_ + header_count_;
+    }
+
+    const HTTP::HeaderView& header(size_t i) const noexcept {
+        return headers_[i];
+    }
+
+    /**
+     * @brief Get the value of the first header field named 'name'
+     *        (case-insensitive).
+     *
+     * @return An empty view if it is not found.
+     */
+    std::string_view find(std::string_view name) const noexcept;
+
+    std::string_view find(HTTP::HeaderFieldName name) const noexcept {
+        return find(HTTP::HeaderKeyName[name]);
+    }
+
+    bool has(std::string_view name) const noexcept;
+
+    std::string_view body() const noexcept {
+        return body_;
+    }
+
+    bool hasContentLength() const noexcept {
+        return has_length_;
+    }
+
+    // The value of 'Content-Length', 0 if there is none.
+    size_t contentLength() const noexcept {
+        return content_length_;
+    }
+
+    // Whether the last transfer coding is "chunked".
+    bool isChunked() const noexcept {
+        return chunked_;
+    }
+
+    // Length of the head (the request line and the header fields).
+    size_t headSize() const noexcept {
+        return head_size_;
+    }
+
+    // Length of the head and the body.
+    size_t size() const noexcept {
+        return head_size_ + body_.size();
+    }
+
+    /**
+     * @brief Copy the data into an 'HttpRequest'.
+     */
+    HttpRequest toRequest() const;
+
+private:
+    HTTP::ReqMethod  method_ = HTTP::REQ_NONE;
+    std::string_view method_name_;
+    std::string_view uri_;
+    std::string_view version_;
+    std::string_view body_;
+    size_t           head_size_ = 0;
+    size_t           content_length_ = 0;
+    bool             has_length_ = false;
+    bool             chunked_ = false;
+    size_t           header_count_ = 0;
+    HTTP::HeaderView headers_[MAX_HEADERS];
+
+    // It collects the body which is not in the parsed data.
+    friend class HttpRequestParser;
+
+}; // class HttpRequestView
+
+} // namespace tab
+
+#endif // __HTTP_REQUEST_VIEW_HPP__
@@ -1,6 +1,8 @@
 #ifndef __HTTP_RESPONSE_HPP__
 #define __HTTP_RESPONSE_HPP__
 
+#include <ctime>
+#include <memory>
 #include <string>
 
 #include "EzNet/HTTP/HTTP_StatusLine.hpp"
@@ -9,6 +11,64 @@
 
 namespace tab {
 
+/**
+ * @brief A range of a file sent as the body of an 'HttpResponse'. 
+ *        'HttpServer' writes it to the socket by sendfile(2) (or splice(2)),
+ *        so it is never read into user space.
+ *
+ * It is shared by the copies of the response, and the file (if it is 
+ * owned) is closed when the last of them is destroyed, after the server
+ * has sent it.
+ */
+class HttpFileBody {
+public:
+    /**
+     * @brief Open the file at 'path', the whole of which is the body.
+     *
+     * @throw std::runtime_error if it can not be opened, or it is not 
+     *        a regular file.
+     */
+    explicit HttpFileBody(const std::string& path);
+
+    /**
+     * @brief The 'size' bytes from 'offset' of the open file 'fd' are the
+     *        body. The file is closed with the body if 'owned' is set.
+     */
+    HttpFileBody(int fd, unsigned long long offset, unsigned long long size,
+                 bool owned = false);
+
+    HttpFileBody(const HttpFileBody&) = delete;
+    HttpFileBody& operator=(const HttpFileBody&) = delete;
+
+    ~HttpFileBody();
+
+    int getFile() const noexcept {
+        return fd_;
+    }
+
+    unsigned long long getOffset() const noexcept {
+        return offset_;
+    }
+
+    unsigned long long getSize() const noexcept {
+        return size_;
+    }
+
+    // When the file was modified, 0 if it is unknown.
+    std::time_t getModifiedTime() const noexcept {
+        return modified_;
+    }
+
+private:
+    int                fd_;
+    unsigned long long offset_;
+    unsigned long long size_;
+    std::time_t        modified_ = 0;
+    bool               owned_;
+
+}; // class HttpFileBody
+
+
 class HttpResponse {
 public:
     HttpResponse(void) = default;
@@ -19,7 +79,8 @@ public:
         status_line_(std::move(val.status_line_)),
         headers_(std::move(val.headers_)),
         cookies_(std::move(val.cookies_)),
-        body_(std::move(val.body_)) { }
+        body_(std::move(val.body_)),
+        file_(std::move(val.file_)) { }
 
     HttpResponse(const std::string& raw) :
         HttpResponse(std::move(parse(raw))) { }
@@ -29,6 +90,7 @@ public:
         headers_ = val.headers_;
         cookies_ = val.cookies_;
         body_ = val.body_;
+        file_ = val.file_;
         return *this;
     }
     
@@ -37,6 +99,7 @@ public:
         headers_ = std::move(val.headers_);
         cookies_ = std::move(val.cookies_);
         body_ = std::move(val.body_);
+        file_ = std::move(val.file_);
         return *this;
     }
 
@@ -44,6 +107,18 @@ public:
 
     std::string getStr(void) const;
 
+    /**
+     * @brief Append the status line, the headers, the cookies and the 
+     *        empty line to 'out', which are followed by the body.
+     */
+    void appendHeadTo(std::string& out) const;
+
+    /**
+     * @brief Append the part of 'appendHeadTo()' after the status line: 
+     *        the headers, the cookies and the empty line.
+     */
+    void appendFieldsTo(std::string& out) const;
+
     operator std::string(void) const {
         return getStr();
     }
@@ -80,6 +155,12 @@ public:
         headers_.addHeader(std::move(header));
     }
 
+    /**
+     * @brief Add a header field line such as "Name: value", without 
+     *        the line break. "Set-Cookie" is added to the cookies.
+     */
+    void addField(const char* line, size_t len);
+
     HTTP::StatusLine& getStatusLine(void) noexcept {
         return status_line_;
     }
@@ -104,11 +185,37 @@ public:
         return body_;
     }
 
+    /**
+     * @brief Send a range of a file as the body instead of 'getBody()'. 
+     *        'HttpServer' fills "Content-Length" and "Last-Modified", and 
+     *        answers the "Range" of the request with a part of it.
+     *
+     * @note 'getStr()' does not include it.
+     */
+    void setFileBody(std::shared_ptr<const HttpFileBody> file) noexcept {
+        file_ = std::move(file);
+    }
+
+    /**
+     * @brief Send the whole of the file at 'path' as the body.
+     *
+     * @throw std::runtime_error if it can not be opened.
+     */
+    void setFileBody(const std::string& path) {
+        file_ = std::make_shared<const HttpFileBody>(path);
+    }
+
+    // Null if the body is 'getBody()'.
+    const std::shared_ptr<const HttpFileBody>& getFileBody() const noexcept {
+        return file_;
+    }
+
 protected:
     HTTP::StatusLine status_line_;
     HTTP::Headers headers_;
     HTTP::Cookies cookies_;
     std::string body_;
+    std::shared_ptr<const HttpFileBody> file_;
 
     friend class Receiver;
     
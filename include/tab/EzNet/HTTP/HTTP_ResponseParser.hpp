@@ -0,0 +1,140 @@
+#ifndef __HTTP_RESPONSE_PARSER_HPP__
+#define __HTTP_RESPONSE_PARSER_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "HTTP_ChunkedDecoder.hpp"
+#include "HTTP_Response.hpp"
+
+namespace tab {
+
+/**
+ * @brief An incremental response parser, which can be fed with the data
+ *        of a connection in pieces of any size, for the clients which do
+ *        not block on the socket.
+ *
+ * The body may have 'Content-Length', be chunked, or last until the
+ * connection is closed, which is told by 'finish()'. The informational
+ * (1xx) responses before the final one are skipped.
+ */
+class HttpResponseParser {
+public:
+    enum class Status {
+        NEED_MORE, // the response is not complete yet
+        COMPLETE,  // 'response()' is ready
+        INVALID,   // syntax error
+        TOO_LARGE  // the head or the body exceeds the limit
+    };
+
+    struct Limits {
+        size_t max_head_size = 65536;
+        // 0 for no limit.
+        size_t max_body_size = 0;
+    };
+
+public:
+    HttpResponseParser() { }
+    HttpResponseParser(const Limits& l) : limits_(l) { }
+
+    /**
+     * @brief Parse the data following the ones fed before.
+     *
+     * @param consumed Set to the number of bytes used. It is less than
+     *                 'len' only if the response completes before the end
+     *                 of the data.
+     *
+     * @note After COMPLETE, INVALID or TOO_LARGE, call 'reset()' before
+     *       feeding the next response.
+     */
+    Status feed(const char* data, size_t len, size_t& consumed);
+
+    /**
+     * @brief Tell the parser that the connection has been closed.
+     *
+     * @return COMPLETE if the body lasts until the connection is closed,
+     *         INVALID if the response is cut off, or NEED_MORE if nothing
+     *         of it has been fed.
+     */
+    Status finish();
+
+    /**
+     * @brief Get the response parsed, valid after COMPLETE.
+     */
+    HttpResponse& response() noexcept {
+        return response_;
+    }
+
+    /**
+     * @brief Pass the body to 'sink' piece by piece instead of collecting
+     *        it in the body of 'response()'.
+     */
+    void setBodySink(std::function<void(const char*, size_t)> sink) {
+        sink_ = std::move(sink);
+    }
+
+    /**
+     * @brief The next response has no body whatever its head says,
+     *        which is the case of the response to a "HEAD" request.
+     */
+    void setNoBody(bool no_body = true) noexcept {
+        no_body_ = no_body;
+    }
+
+    Limits& limits() noexcept {
+        return limits_;
+    }
+
+    // Whether a part of the next response has been fed.
+    bool started() const noexcept {
+        return state_ != State::HEAD || !head_.empty();
+    }
+
+    /**
+     * @brief Whether the connection can be used for another request
+     *        after the response completed.
+     */
+    bool reusable() const noexcept {
+        return reusable_;
+    }
+
+    /**
+     * @brief Prepare for the next response, the memory allocated is kept.
+     *
+     * @note 'setNoBody()' is reset.
+     */
+    void reset() noexcept;
+
+private:
+    enum class State {
+        HEAD,          // the status line and the header fields
+        BODY,          // the body with 'Content-Length'
+        CHUNKED,       // the chunked body, see 'ChunkedDecoder'
+        UNTIL_CLOSE,   // the body lasting until the connection is closed
+        DONE
+    };
+
+    Status parseHead(const char*& p, const char* end);
+    Status startBody();
+    Status emitBody(const char* p, size_t n);
+
+    Limits         limits_;
+    State          state_ = State::HEAD;
+    HttpResponse   response_;
+    std::string    head_;
+    // Where to continue searching the end of the head in 'head_'.
+    size_t         head_scan_ = 0;
+    size_t         body_size_ = 0;
+    // Bytes left of the body.
+    size_t         remaining_ = 0;
+    bool           no_body_ = false;
+    bool           reusable_ = false;
+    ChunkedDecoder chunked_;
+    std::function<void(const char*, size_t)> sink_;
+
+}; // class HttpResponseParser
+
+} // namespace tab
+
+#endif // __HTTP_RESPONSE_PARSER_HPP__
@@ -1,35 +1,20 @@
 #ifndef __HTTP_SERVER_HPP__
 #define __HTTP_SERVER_HPP__
 
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include "EzNet/Socket/TcpServer.hpp"
 
 #include "HTTP_Request.hpp"
+#include "HTTP_RequestParser.hpp"
+#include "HTTP_RequestView.hpp"
 #include "HTTP_Response.hpp"
 
 namespace tab {
 
-class HttpServer : public TcpServer {
-public:
-    struct HttpConfig {
-        bool keep_alive = false;
-    };
-
-public:
-    HttpServer();
-    HttpServer(const TcpConfig&);
-
-    HttpConfig& configHTTP() {
-        return config_http_;
-    }
-
-private:
-    void loadEventListeners();
-
-    HttpConfig config_http_;
-
-}; // class HttpServer
-
-
 class HttpServerEvent : public TcpServerEvent {
 public:
     constexpr static event_type_id_t GetEventTypeID() {
@@ -45,8 +30,22 @@ public:
         return HttpServerEvent::GetEventTypeID() + 1;
     }
 
-    auto& getRequest() {
-        return request_;
+    /**
+     * @brief Get the request as an 'HttpRequest'.
+     * 
+     * @note The request is parsed without copying anything, and it is 
+     *       copied into an 'HttpRequest' when this is called the first 
+     *       time. Use 'getRequestView()' if the copy is not necessary.
+     */
+    HttpRequest& getRequest() {
+        if (!request_)
+            request_.emplace(view_.toRequest());
+        return *request_;
+    }
+
+    // Valid during the handling of this event only.
+    const HttpRequestView& getRequestView() const {
+        return view_;
     }
 
     auto& getResponse() {
@@ -57,16 +56,100 @@ public:
         close_ = true;
     }
 
+    /**
+     * @brief Send the block of header fields registered by 
+     *        'HttpServer::addStaticHeaders()' with the response.
+     */
+    void addStaticHeaders(size_t id) {
+        if (id < 64)
+            static_headers_ |= 1ULL << id;
+    }
+
 protected:
-    HttpRequest request_;
+    const HttpRequestView&     view_;
+    std::optional<HttpRequest> request_;
     HttpResponse response_;
     bool close_ = false;
+    // The bits of the static header blocks selected.
+    unsigned long long static_headers_ = 0;
 
-    HttpRequestReceivedEvent(HttpRequest&& r) : request_(std::move(r)) { }
+    HttpRequestReceivedEvent(const HttpRequestView& v) : view_(v) { }
 
     friend class HttpServer;
 }; // class HttpServerReceivedEvent
 
+
+class HttpServer : public TcpServer {
+public:
+    struct HttpConfig {
+        bool keep_alive = false;
+        // Send "Date" with the responses which do not have one. It is 
+        // formatted once per second in each thread.
+        bool date_header = true;
+        // A request is parsed as its data arrive, and it is rejected 
+        // if it exceeds these limits.
+        HttpRequestParser::Limits limits;
+    };
+
+public:
+    HttpServer();
+    HttpServer(const TcpConfig&);
+
+    HttpConfig& configHTTP() {
+        return config_http_;
+    }
+
+    /**
+     * @brief Register a block of header fields which never change, such 
+     *        as "Server" or the ones of CORS. It is rendered once, and 
+     *        copied into a response as a whole: into every response if 
+     *        'always' is set, otherwise into the ones selected by 
+     *        'HttpRequestReceivedEvent::addStaticHeaders()'. Call it 
+     *        before 'start()'.
+     *
+     * @note The fields are not checked against the ones of the response, 
+     *       so do not set them in both.
+     *
+     * @return The ID of the block.
+     * @throw std::logic_error if 64 blocks have been registered.
+     */
+    size_t addStaticHeaders(const HTTP::Headers& headers, 
+                            bool always = false) {
+        if (static_headers_.size() >= 64)
+            throw std::logic_error(
+                "tab::HttpServer::addStaticHeaders(): "
+                "Too many blocks of static headers.");
+        static_headers_.push_back({ headers.getStr(), always });
+        return static_headers_.size() - 1;
+    }
+
+    // The events of HTTP are dispatched statically as well, 
+    // the others are passed to 'TcpServer'.
+    template <class Event, typename Func>
+    HttpServer& registerEvent(Func f) {
+        if constexpr (HttpEventMatcher::Contains<Event>())
+            http_matcher_.set<Event>(f);
+        else
+            TcpServer::registerEvent<Event>(f);
+        return *this;
+    }
+
+private:
+    using HttpEventMatcher = StaticEventMatcher<HttpRequestReceivedEvent>;
+
+    struct StaticHeaders {
+        std::string fields; // rendered, each line ends with "\r\n"
+        bool        always;
+    };
+
+    void loadEventListeners();
+
+    HttpConfig config_http_;
+    HttpEventMatcher http_matcher_;
+    std::vector<StaticHeaders> static_headers_;
+
+}; // class HttpServer
+
 } // namespace tab
 
 #endif // __HTTP_SERVER_HPP__
\ No newline at end of file
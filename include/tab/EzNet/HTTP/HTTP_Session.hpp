@@ -15,10 +15,12 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "EzNet/Socket/StreamSocket.hpp"
 #include "EzNet/Utility/Network/URL.hpp"
 #include "EzNet/Utility/IO/IO.hpp"
+#include "HTTP_ConnectionPool.hpp"
 #include "HTTP_Request.hpp"
 #include "HTTP_Response.hpp"
 
@@ -73,11 +75,14 @@ protected:
  */
 class HttpSessionClient : public HttpSession {
 protected:
-    using SocketGenerator = std::function<std::shared_ptr<Socket>(af_t, char)>;
+    // (address family, 1 for a secure socket, host name)
+    using SocketGenerator = std::function<
+        std::shared_ptr<Socket>(af_t, char, const std::string&)>;
     
     // For 'GetNewSession()' in HTTP_Client.cpp
     HttpSessionClient(SocketGenerator sg);
     friend HttpSessionClient GetNewSession();
+    friend class HttpClient;
 
 public:
     // Copy
@@ -86,10 +91,9 @@ public:
     // Move
     HttpSessionClient(HttpSessionClient&& hs);
 
-    // This destructor won't do anything else, because
-    // all the members can be destructed safely without
-    // any other operations. (Thanks to smart pointers.)
+    // The connection is returned to the pool of the client.
     ~HttpSessionClient() {
+        releaseSocket();
     }
 
     // Move (or swap)
@@ -199,9 +203,36 @@ public:
      */
     HttpResponse& request(void);
 
+    /**
+     * @brief Perform the requests on one keep-alive connection with
+     *        pipelining: they are written back-to-back, and the responses
+     *        are read in order, so a batch to the same host takes about
+     *        one round trip instead of one for each request.
+     * 
+     * @param requests The requests to the current target, whose "Host"
+     *                 is set if it is absent.
+     * @param max_in_flight At most this many requests are sent before
+     *                      their responses are read.
+     * @return The responses, with the bodies in them (the writer of
+     *         this session is not used).
+     * 
+     * @note If the server closes the connection before answering all of
+     * @note them, the rest are sent again on a new connection. So only 
+     * @note idempotent requests (such as "GET") should be batched.
+     * @note Redirections are not followed.
+     */
+    std::vector<HttpResponse> requestBatch(
+        const std::vector<HttpRequest>& requests, size_t max_in_flight = 32);
+
 protected:
     // send a request and receive a response
     void performSingleRequest(char*, const size_t);
+    // borrow a connection to the target from the pool
+    bool borrowSocket();
+    // make a new connection to the target
+    void connectSocket();
+    // return the connection to the pool, or close it
+    void releaseSocket();
     // send and receive till the response code is not 301 or 302
     void performSerialRequest();
 
@@ -214,6 +245,8 @@ protected:
     URL target_;
     std::function<size_t(const void*, size_t)> writer_;
     SocketGenerator get_socket_;
+    // The pool of the client, may be null.
+    std::shared_ptr<HttpConnectionPool> pool_;
     
 }; // class Session
 
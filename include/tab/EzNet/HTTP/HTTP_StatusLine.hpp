@@ -113,16 +113,19 @@ public:
 
     std::string getStr(void) const {
         std::string ret;
-        ret.append("HTTP/");
-        ret.append(version_);
-        ret.push_back(' ');
-        ret.append(std::to_string((int)code_));
-        ret.push_back(' ');
-        ret.append(phrase_);
-        ret.append("\r\n");
+        appendTo(ret);
         return ret;
     }
 
+    /**
+     * @brief Append the line (with the line break) to 'out'.
+     * 
+     * @note The lines are cached by each thread for every code, so the 
+     *       line of a code is rendered again only if its version or 
+     *       phrase changes.
+     */
+    void appendTo(std::string& out) const;
+
     operator std::string() const {
         return getStr();
     }
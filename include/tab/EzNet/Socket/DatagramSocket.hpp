@@ -2,6 +2,8 @@
 #define __DATAGRAMSOCKET_HPP__
 
 // Importing standard libraries.
+#include <cstddef>
+#include <cstring>
 #include <string>
 
 // Other dependencies.
@@ -12,6 +14,43 @@
 
 namespace tab {
 
+/**
+ * @brief A datagram of the batch I/O of 'DatagramSocket', whose buffer is
+ *        provided by the caller, so that nothing is allocated per packet.
+ */
+struct Datagram {
+    char*     buffer   = nullptr;
+    // Size of 'buffer'
+    size_t    capacity = 0;
+    // Bytes to send, or bytes received
+    size_t    length   = 0;
+    // The destination to send to, or the source received from
+    sockaddr_storage addr {};
+    socklen_t        addr_len = 0;
+    // Set if the datagram received is larger than 'capacity'.
+    bool      truncated = false;
+    // Linux only. 'buffer' holds several datagrams of this size (the last
+    // one may be shorter), sent by UDP GSO or received by UDP GRO. 0 if it
+    // is one datagram.
+    size_t    segment_size = 0;
+
+    Datagram() = default;
+
+    Datagram(char* buf, size_t cap, size_t len = 0) : 
+        buffer(buf), capacity(cap), length(len) { }
+
+    void setAddress(const Address& a) {
+        addr_len = static_cast<socklen_t>(a.getSize());
+        std::memcpy(&addr, a.get().get(), addr_len);
+    }
+
+    Address getAddress() const {
+        return Address(*reinterpret_cast<const sockaddr_t*>(&addr), 
+                       IPPROTO_UDP);
+    }
+
+}; // struct Datagram
+
 
 class DatagramSocket : public SocketBase<SOCK_DGRAM, IPPROTO_UDP> {
 private:
@@ -24,7 +63,8 @@ public:
     DatagramSocket(const DatagramSocket&) = delete;
 
     DatagramSocket(DatagramSocket&& ds) noexcept : 
-        _Base(std::move(ds)), dest_(std::move(ds.dest_)) { }
+        _Base(std::move(ds)), dest_(std::move(ds.dest_)), 
+        gro_(ds.gro_), gso_failed_(ds.gso_failed_) { }
     
     DatagramSocket(port_t port, const std::string& addr) : 
         DatagramSocket() {
@@ -62,6 +102,53 @@ public:
     
     std::string recv(int limit = 1024);
 
+    /**
+     * @brief Send 'count' datagrams, each to its own address, with as few
+     *        system calls as possible (sendmmsg() on Linux).
+     * 
+     * @return int The number of datagrams sent, which may be less than 
+     *         'count' if the socket would block or an error occurred 
+     *         after some of them are sent. -1 if none is sent.
+     */
+    int sendBatch(const Datagram* packets, int count);
+
+    /**
+     * @brief Receive up to 'count' datagrams into the buffers of 'packets'
+     *        (recvmmsg() on Linux), with their lengths and sources.
+     * 
+     * @param block Wait for the first datagram if there is none, and the 
+     *              others are received only if they have arrived.
+     * @return int The number of datagrams received, 0 if there is none 
+     *         and 'block' is false, or -1 if an error occurred.
+     */
+    int recvBatch(Datagram* packets, int count, bool block = true);
+
+    /**
+     * @brief Send 'size' bytes to 'to' as datagrams of 'segment_size' 
+     *        bytes (the last one may be shorter).
+     * 
+     * With UDP GSO (Linux 4.18 or later), up to 64 datagrams are passed to
+     * the kernel by one call as one buffer, and split as late as possible.
+     * Otherwise they are sent one by one.
+     * 
+     * @return long long The bytes sent, or -1 if none is sent. Nothing is
+     *         sent if 'size' is 0.
+     * 
+     * @throw std::invalid_argument if 'segment_size' is larger than 65535.
+     */
+    long long sendSegments(const Address& to, const void* buf, size_t size, 
+                           size_t segment_size);
+
+    /**
+     * @brief Let the kernel coalesce the datagrams of a flow received into
+     *        one buffer (UDP GRO, Linux 5.0 or later), which 'recvBatch()'
+     *        receives with its 'Datagram::segment_size'. The buffers should
+     *        be 64 KiB to hold them.
+     * 
+     * @return false if it is not supported.
+     */
+    bool enableGro(bool enable = true);
+
     /**
      * @brief Set the destination. It's 
      * @brief necessary when you need to call 'send()'
@@ -127,6 +214,10 @@ public:
 
 protected:
     Address dest_;
+    bool    gro_ = false;
+    // Set if the kernel refused UDP GSO, then the segments are sent one 
+    // by one.
+    bool    gso_failed_ = false;
     
 }; // class DatagramSocket
 
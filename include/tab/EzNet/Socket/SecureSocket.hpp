@@ -6,12 +6,19 @@
 #ifdef EN_OPENSSL
 
 #include <memory>
+#include <string>
 
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
 #include "StreamSocket.hpp"
 
+// kTLS needs the support of both the kernel and OpenSSL (3.0 or later).
+#if defined(_LINUX) && defined(SSL_OP_ENABLE_KTLS) && \
+    !defined(OPENSSL_NO_KTLS)
+#  define EN_KTLS
+#endif
+
 namespace tab {
 
 class SslContext;
@@ -21,8 +28,26 @@ class SecureServerSocket;
 
 /**
  * @brief Object-oriented encapsulation of SSL_CTX
+ * 
+ * The copies share the same SSL_CTX, with a cache of the sessions got 
+ * as a client, so that the connections to a host seen before resume the
+ * session (with a session ticket, or a PSK of TLS 1.3) instead of doing
+ * a full handshake. See 'SecureSocket::setHostName()'.
  */
 class SslContext {
+public:
+    /**
+     * @brief Counters of the handshakes done with the context.
+     */
+    struct HandshakeStats {
+        // As a client, counted by 'SecureSocket::connect()'.
+        unsigned long long client_full    = 0;
+        unsigned long long client_resumed = 0;
+        // As a server, counted by OpenSSL.
+        unsigned long long server_full    = 0;
+        unsigned long long server_resumed = 0;
+    };
+
 public:
     SslContext();
 
@@ -45,8 +70,16 @@ public:
         setVerifyLocation(CAfile.c_str(), CApath.c_str());
     }
 
+    void setCertificateFile(const char* file) {
+        if (SSL_CTX_use_certificate_chain_file(context_.get(), file) <= 0) {
+            throw std::runtime_error(
+                std::string("tab::SslContext::setCertificateFile():(OpenSSL) ")
+                + ERR_error_string(ERR_get_error(), nullptr));
+        }
+    }
+
     void setPrivateKeyFile(const char* file) {
-        if (SSL_CTX_use_certificate_file(context_.get(), 
+        if (SSL_CTX_use_PrivateKey_file(context_.get(), 
                                         file, SSL_FILETYPE_PEM) <= 0) {
             throw std::runtime_error(
                 std::string("tab::SslContext::setPrivateKeyFile():(OpenSSL) ")
@@ -54,6 +87,57 @@ public:
         }
     }
 
+    /**
+     * @brief Set the number of the hosts whose sessions are kept for 
+     *        resumption as a client, 0 to disable it (256 by default).
+     */
+    void setSessionCacheSize(size_t hosts);
+
+    /**
+     * @brief Keep the sessions as a server, so that the clients can
+     *        resume them by the session ID, besides the session tickets.
+     * 
+     * @param size Sessions kept at most
+     * @param timeout_seconds Lifetime of a session (and a ticket)
+     */
+    void enableServerSessionCache(long size = 20480, 
+                                  long timeout_seconds = 300);
+
+    /**
+     * @brief Set the keys to encrypt the session tickets as a server.
+     * 
+     * The servers (processes or 'SslContext's) sharing the same keys can
+     * resume the sessions of each other. Otherwise the keys are random
+     * for each SSL_CTX.
+     * 
+     * @param keys 80 bytes, see 'GenerateTicketKeys()'.
+     */
+    void setTicketKeys(const std::string& keys);
+
+    /**
+     * @brief Make 80 random bytes for 'setTicketKeys()'.
+     */
+    static std::string GenerateTicketKeys();
+
+    /**
+     * @brief Let the kernel encrypt and decrypt the records after the 
+     *        handshake (kTLS), with no encryption and copy in user space.
+     * 
+     * OpenSSL falls back to doing it itself for a connection if the kernel
+     * does not support it (e.g. the "tls" module is not loaded) or the 
+     * cipher negotiated. See 'SecureSocket::kernelTlsSend()'.
+     * 
+     * @note Call it before the connections are made.
+     * @return false if this build does not support it (only on Linux).
+     */
+    bool enableKernelTls(bool enable = true);
+
+    HandshakeStats getHandshakeStats() const;
+
+    SSL_CTX* get() const noexcept {
+        return context_.get();
+    }
+
 private:
     friend class SecureSocket;
     std::shared_ptr<SSL_CTX> context_;
@@ -131,6 +215,21 @@ public:
         return this->connect(target, 50, 2);
     }
 
+    /**
+     * @brief Set the name of the server (SNI) to connect to, and resume 
+     *        the session with it kept in the context if there is one.
+     * 
+     * @note Call it before 'connect()'.
+     */
+    void setHostName(const std::string& host);
+
+    /**
+     * @brief Whether the session was resumed by the last handshake.
+     */
+    bool sessionReused() const noexcept {
+        return SSL_session_reused(ssl_.get()) == 1;
+    }
+
     int send(const char* buf, int size, bool block = true) override;
     
     int send(const std::string& buf, bool block = true) override {
@@ -141,9 +240,38 @@ public:
     
     std::string recv(int buffer_size = 1024, bool block = true) override;
 
+    /**
+     * @brief Whether the records sent are made by the kernel (kTLS), so
+     *        that the data is sent by 'send()' of the socket directly.
+     */
+    bool kernelTlsSend() const noexcept {
+        return ktls_send_;
+    }
+
+    /**
+     * @brief Whether the records received are decrypted by the kernel.
+     * 
+     * @note They are still read by OpenSSL (without decryption), which 
+     *       handles the records other than data, such as the tickets.
+     */
+    bool kernelTlsRecv() const noexcept;
+
+#ifdef _LINUX
+    /**
+     * @brief Send 'size' bytes of the file 'fd' from 'offset'. With kTLS 
+     *        it is sent by sendfile() without being read to user space,
+     *        otherwise it is read and encrypted by OpenSSL.
+     * 
+     * @return Bytes sent, or -1 if nothing is sent because of an error.
+     */
+    long long sendFile(int fd, off_t offset, size_t size);
+#endif
+
 protected:
     std::shared_ptr<SSL_CTX> ssl_context_;
     std::shared_ptr<SSL> ssl_;
+    // Set after the handshake.
+    bool ktls_send_ = false;
 
 }; // class SecureSocket
 
@@ -326,11 +326,11 @@ protected:
     bool     destroy_ = true;
     
     static void closer_s_c(socket_t s) {
-        _shutdown(s, SD_BOTH);
+        _shutdown(s, BOTH);
         _close(s);
     }
     static void closer_s(socket_t s) {
-        _shutdown(s, SD_BOTH);
+        _shutdown(s, BOTH);
     }
     static void closer_c(socket_t s) {
         _close(s);
@@ -10,14 +10,14 @@
 #define __TCP_SERVER__
 
 #include <climits>
-#include <ctime>
-#include <map>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#include "SecureSocket.hpp"
 #include "StreamSocket.hpp"
 #include "TcpServerEvents.hpp"
 
@@ -25,22 +25,69 @@
 #include "EzNet/Utility/Network/Address.hpp"
 #include "EzNet/Utility/Network/URL.hpp"
 #include "EzNet/Utility/Event/EventMatcher.hpp"
+#include "EzNet/Utility/Event/StaticEventMatcher.hpp"
 
 namespace tab {
 
 class TcpServer {
 public:
     struct TcpConfig {
+        enum class IOBackend {
+            DEFAULT,  // IOCP on Windows, epoll on Linux
+            IO_URING  // Linux only, falls back to epoll if it's unavailable
+        };
+
+
         TcpConfig() : listen_address(Address::GetLocalAddress()) {
             listen_address.setPort(80);
         }
         Host     listen_address;
+        // Linux (epoll) only, and OpenSSL is required. The connections 
+        // accepted are TLS, whose handshakes are done in the event loop 
+        // before 'ConnectionAcceptedEvent' is dispatched, and the events 
+        // carry the decrypted data. The io_uring backend is not used.
         bool     tls_enable   = false;
+        // PEM files of the certificate (chain) and its private key.
+        std::string tls_certificate_file;
+        std::string tls_private_key_file;
+        // The protocols accepted by ALPN, in order of preference, such as
+        // {"h2", "http/1.1"}. A client offering none of them is still 
+        // accepted without ALPN.
+        std::vector<std::string> tls_alpn_protocols;
         short    concurrent_threads = 1; // This variable should > 0
+        // Linux only. Every handler thread listens on its own socket bound
+        // with SO_REUSEPORT, so the kernel spreads the connections among
+        // the threads instead of all of them accepting from one queue.
+        bool     reuse_port = false;
+        // Linux only. A connection is closed when it has waited longer 
+        // than these for the next request (idle, or the TLS handshake), 
+        // for the rest of a request since its first data (read), or for
+        // the peer to take what is written (write, renewed by every 
+        // progress). 0 means 'connection_timeout_seconds', and a negative
+        // one (or INT_MAX) means no limit. A handler which keeps reading 
+        // a stream should disable the read timeout.
         int      connection_timeout_seconds = INT_MAX;
+        int      idle_timeout_seconds  = 0;
+        int      read_timeout_seconds  = 0;
+        int      write_timeout_seconds = 0;
+        IOBackend io_backend = IOBackend::DEFAULT;
+        // io_uring only: size of the submission queue.
+        unsigned uring_queue_depth = 1024;
+        // Linux only. Connection contexts are recycled by a pool in each 
+        // handler thread: 'prewarm' ones are allocated when starting (and 
+        // their buffers are registered to io_uring), and at most 'capacity' 
+        // idle ones are kept.
+        unsigned context_pool_prewarm  = 256;
+        unsigned context_pool_capacity = 4096;
         // TODO
     }; // struct TcpConfig
 
+    // The handlers of the connection events are called for every I/O 
+    // operation completed, so they are dispatched statically.
+    using TcpEventMatcher = StaticEventMatcher<
+        ConnectionAcceptedEvent, DataReceivedEvent, DataSentEvent,
+        ConnectionClosedEvent>;
+
 public:
     TcpServer() {}
     TcpServer(const TcpConfig& cfg) : config_(cfg) {}
@@ -53,44 +100,97 @@ public:
         return config_;
     }
 
+#ifdef EN_OPENSSL
+    /**
+     * @brief The context of the TLS connections, for the settings beyond
+     *        'TcpConfig', such as 'SslContext::setTicketKeys()' and 
+     *        'SslContext::enableKernelTls()'. Call it before 'start()'.
+     */
+    SslContext& configTLS() {
+        if (!tls_context_)
+            tls_context_.reset(new SslContext);
+        return *tls_context_;
+    }
+#endif
+
     TcpServer& checkConfig() {
         if (config_.concurrent_threads <= 0)
             throw std::logic_error(
                 "Tab::TcpServer::checkConfig(): "
                 "Number of concurrent threads is invalid.");
+        if (config_.tls_enable) {
+#if !defined(EN_OPENSSL) || !defined(_LINUX)
+            throw std::logic_error(
+                "Tab::TcpServer::checkConfig(): "
+                "TLS is only supported on Linux with OpenSSL.");
+#endif
+            if (config_.tls_certificate_file.empty() || 
+                config_.tls_private_key_file.empty())
+                throw std::logic_error(
+                    "Tab::TcpServer::checkConfig(): "
+                    "The certificate and the private key are required.");
+            for (auto& p : config_.tls_alpn_protocols)
+                if (p.empty() || p.size() > 255)
+                    throw std::logic_error(
+                        "Tab::TcpServer::checkConfig(): "
+                        "Invalid ALPN protocol name.");
+        }
         return *this;
     }
 
     TcpServer& start();
     TcpServer& stop();
+
+    struct ContextPoolStats {
+        unsigned long long hits   = 0; // contexts reused by connections
+        unsigned long long misses = 0; // contexts allocated for connections
+    };
+    // Linux only, sums up the pools of all the handler threads.
+    ContextPoolStats getContextPoolStats() const;
     
     template <class Event, typename Func>
     TcpServer& registerEvent(Func f) {
         static_assert(std::is_base_of<TcpServerEvent, Event>::value,
                       "The registered event must be derived "
                       "from 'tab::TcpServerEvent'.");
-        event_matcher_.set<Event>(f);
+        if constexpr (TcpEventMatcher::Contains<Event>())
+            tcp_matcher_.set<Event>(f);
+        else // events of the derived servers
+            event_matcher_.set<Event>(f);
         return *this;
     }
 
 protected:
     TcpConfig config_;
-    std::unique_ptr<ServerSocket> socket_;
-    std::map<std::clock_t, StreamSocket> socket_list_;
+    TcpEventMatcher tcp_matcher_;
     EventMatcher event_matcher_;
     enum {INIT, RUNNING, STOPPED, ENCOUNTER_ERROR} status_ = INIT;
 
     // Threads
     std::vector<std::unique_ptr<std::thread>> handlers_;
-    friend void HandlerThread(TcpServer&);
+    friend void HandlerThread(TcpServer&, size_t);
 
 #ifdef _WINDOWS
+    std::unique_ptr<ServerSocket> socket_;
+    void*  acceptor_ctx_ = nullptr;
     HANDLE completion_port_;
-    void*  acceptor_ctx_;
 #endif
 #ifdef _LINUX
-
+    // One listening socket, or one per handler thread when 
+    // 'TcpConfig::reuse_port' is enabled.
+    std::vector<std::unique_ptr<ServerSocket>> listeners_;
+    std::vector<void*> acceptors_;
+    std::vector<void*> pools_; // one for each handler thread
+    // Wakes all the handler threads up when the server is stopping.
+    int    event_fd_ = -1;
+    bool   use_uring_ = false;
 #endif 
+#ifdef EN_OPENSSL
+    // Shared by the connections when 'TcpConfig::tls_enable' is set.
+    std::unique_ptr<SslContext> tls_context_;
+    // 'TcpConfig::tls_alpn_protocols' in the wire format of ALPN.
+    std::string alpn_wire_;
+#endif
 
 }; // class TcpServer
 
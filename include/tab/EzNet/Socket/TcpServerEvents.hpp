@@ -2,13 +2,34 @@
 #define __TCP_SERVER_EVENTS__
 
 #include <climits>
+#include <cstddef>
+#include <cstring>
 #include <exception>
 #include <stdexcept>
+#include <string>
 
 #include "EzNet/Utility/Event/Event.hpp"
 
 namespace tab {
 
+class TimerWheel;
+
+/**
+ * @brief A piece of the data written by one gathering write, 
+ *        see 'TcpServerEventBase::setOutputSegments()'.
+ *
+ * If 'file' is a descriptor (not -1), the piece is the 'size' bytes from
+ * 'offset' of the file instead of 'data', which are written by sendfile(2)
+ * without being read into user space (by splice(2) on io_uring). The file
+ * is read from 'offset' directly, its file position is not used.
+ */
+struct OutputSegment {
+    const char*        data;
+    size_t             size;
+    int                file   = -1;
+    unsigned long long offset = 0;
+};
+
 class TcpServerEvent : public Event {
 public:
     enum OPERATION {
@@ -79,11 +100,27 @@ public:
         next_operation_ = o;
     }
 
+    /**
+     * @brief Write the 'count' segments in order by gathering writes 
+     *        (sendmsg() on Linux) as the next operation, instead of the 
+     *        buffer. They are not copied, so they (and the array) must 
+     *        stay valid until 'DataSentEvent' is dispatched.
+     * 
+     * @note On Windows they (including the files) are copied into the 
+     *       extended buffer.
+     */
+    void setOutputSegments(const OutputSegment* segments, size_t count) {
+        segments_ = segments;
+        segment_count_ = count;
+        next_operation_ = OP_WRITE;
+    }
+
     /**
      * @brief If the default buffer is not large enough,
      *        use this method to get an additional buffer.
      * 
-     * @note Calling this function will lead to a memory allocation, 
+     * @note Calling this function may lead to a memory allocation (a buffer 
+     *       kept from a previous connection is reused if it is large enough), 
      *       and the new buffer will be the buffer used for the next operation. 
      *       (This means that if you required a sending operation, 
      *       the server would send nothing. And if you required a 
@@ -94,12 +131,21 @@ public:
      */
     char* extendBuffer(unsigned long size) {
         if (buffer_add_ != nullptr) {
-            if (buffer_add_size_ <= size) return buffer_add_;
+            if (buffer_add_size_ >= size) return buffer_add_;
             delete[] buffer_add_;
         }
-        // Do not care the deleting operation.
-        // The buffer will be deleted automatically by 'SocketContext'.
-        buffer_add_ = new char[size]();
+        if (buffer_spare_ != nullptr && buffer_spare_size_ >= size) {
+            buffer_add_ = buffer_spare_;
+            size = buffer_spare_size_;
+            std::memset(buffer_add_, 0, size);
+            buffer_spare_ = nullptr;
+            buffer_spare_size_ = 0;
+        }
+        else {
+            // Do not care the deleting operation.
+            // The buffer will be deleted automatically by 'SocketContext'.
+            buffer_add_ = new char[size]();
+        }
         buffer_add_size_ = size;
         allocated_buffer_add_ = true;
         return buffer_add_;
@@ -123,8 +169,44 @@ public:
         return flag_;
     }
 
+    /**
+     * @brief The protocol selected by ALPN for a TLS connection, such as
+     *        "http/1.1", or empty if there is none.
+     */
+    std::string getAlpnProtocol() const {
+        return std::string(alpn_, alpn_size_);
+    }
+
+    /**
+     * @brief A pointer kept for the connection by higher level 
+     *        applications, it is nullptr for a new connection.
+     *
+     * @note The object it points to can be freed when 
+     *       'ConnectionClosedEvent' is received.
+     */
+    void*& userData() {
+        return user_data_;
+    }
+
+    /**
+     * @brief The timers of the handler thread, whose callbacks are called
+     *        in this thread between the events, such as to expire the 
+     *        sessions kept by the handlers. Linux only.
+     *
+     * @note A timer must not be armed by another thread. The ones still
+     *       armed are disarmed without being called when the server stops.
+     */
+    TimerWheel& timers() const {
+        if (timers_ == nullptr)
+            throw std::runtime_error(
+                "tab::TcpServerEventBase::timers(): "
+                "The timers are only supported on Linux.");
+        return *timers_;
+    }
+
 protected: 
-    TcpServerEventBase(unsigned long long& f) : flag_(f) { }
+    TcpServerEventBase(unsigned long long& f, void*& u) : 
+        flag_(f), user_data_(u) { }
 
 private:
     char*         buffer_;
@@ -134,9 +216,17 @@ private:
     unsigned long buffer_add_size_ = 0;
     unsigned long content_size_add_ = 0;
     bool          allocated_buffer_add_ = false;
+    char*         buffer_spare_ = nullptr;
+    unsigned long buffer_spare_size_ = 0;
     BUFFER_CHOICE active_buffer_ = DEFAULT;
     OPERATION     next_operation_ = OP_CLOSE;
+    const char*   alpn_ = "";
+    unsigned      alpn_size_ = 0;
+    const OutputSegment* segments_ = nullptr;
+    size_t        segment_count_ = 0;
+    TimerWheel*   timers_ = nullptr;
     unsigned long long& flag_;
+    void*&        user_data_;
 
     friend class TcpEventInternal;
 
@@ -149,7 +239,8 @@ public:
     }
 
 protected:
-    ConnectionAcceptedEvent(unsigned long long& f) : TcpServerEventBase(f) { }
+    ConnectionAcceptedEvent(unsigned long long& f, void*& u) : 
+        TcpServerEventBase(f, u) { }
 
     friend class ConnectionAcceptedEventInternal;
 
@@ -162,7 +253,8 @@ public:
     }
 
 protected:
-    DataReceivedEvent(unsigned long long& f) : TcpServerEventBase(f) { }
+    DataReceivedEvent(unsigned long long& f, void*& u) : 
+        TcpServerEventBase(f, u) { }
 
     friend class DataReceivedEventInternal;
 };  // class DataReceivedEvent
@@ -174,11 +266,43 @@ public:
     }
 
 protected:
-    DataSentEvent(unsigned long long& f) : TcpServerEventBase(f) { }
+    DataSentEvent(unsigned long long& f, void*& u) : 
+        TcpServerEventBase(f, u) { }
 
     friend class DataSentEventInternal;
 }; // class DataSentEvent
 
+/**
+ * @brief Dispatched once a connection is closed, by the server or by the 
+ *        peer, to release the resources kept in 'userData()'.
+ *
+ * @note The socket has been closed, and there is no buffer to access.
+ */
+class ConnectionClosedEvent : public TcpServerEvent {
+public:
+    constexpr static event_type_id_t GetEventTypeID() {
+        return TcpServerEvent::GetEventTypeID() + 4;
+    }
+
+    unsigned long long& flag() {
+        return flag_;
+    }
+
+    void*& userData() {
+        return user_data_;
+    }
+
+protected:
+    ConnectionClosedEvent(unsigned long long& f, void*& u) : 
+        flag_(f), user_data_(u) { }
+
+private:
+    unsigned long long& flag_;
+    void*&              user_data_;
+
+    friend class ConnectionClosedEventInternal;
+}; // class ConnectionClosedEvent
+
 
 } // namespace tab
 
@@ -2,6 +2,7 @@
 #define __UTILITY_HPP__
 
 #include "Utility/General/Exceptions.hpp"
+#include "Utility/General/Scan.hpp"
 #include "Utility/General/Transform.hpp"
 
 #include "Utility/IO/IO.hpp"
@@ -0,0 +1,93 @@
+#ifndef __STATIC_EVENT_MATCHER_HPP__
+#define __STATIC_EVENT_MATCHER_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Event.hpp"
+
+namespace tab {
+
+/**
+ * @brief An event matcher whose set of events is fixed at compile time.
+ *
+ * Unlike 'EventMatcher', the handler of an event is found by its type
+ * when compiling, so calling it costs no hashing, no 'std::any_cast',
+ * and only the indirect call of 'std::function'. It has the same
+ * interface as 'EventMatcher', except that using an event which is not
+ * in 'Events' does not compile.
+ *
+ * @tparam Events Distinct event types derived from 'tab::Event'.
+ */
+template <typename... Events>
+class StaticEventMatcher {
+    static_assert(std::conjunction<std::is_base_of<Event, Events>...>::value,
+        "All the events must be derived from 'tab::Event'.");
+
+public:
+    template <typename E>
+    constexpr static bool Contains() {
+        return std::disjunction<
+            std::is_same<std::decay_t<E>, Events>...>::value;
+    }
+
+public:
+    template <typename E>
+    auto call(E& e)
+    -> std::enable_if_t<Contains<E>(), StaticEventMatcher&> {
+        auto& f = slot<E>();
+        if (!f)
+            throw std::runtime_error(
+                "tab::StaticEventMatcher::call(): "
+                "No handler is set for the given event.");
+        f(e);
+        return *this;
+    }
+
+    template <typename Arg, typename Func>
+    StaticEventMatcher& set(Func callable) {
+        static_assert(Contains<Arg>(),
+            "The given event is unknown in this container.");
+        slot<Arg>() = std::function<void(std::decay_t<Arg>&)>(callable);
+        return *this;
+    }
+
+    template <typename E>
+    StaticEventMatcher& remove() {
+        static_assert(Contains<E>(),
+            "The given event is unknown in this container.");
+        slot<E>() = nullptr;
+        return *this;
+    }
+
+    template <typename E>
+    bool has() const {
+        static_assert(Contains<E>(),
+            "The given event is unknown in this container.");
+        return static_cast<bool>(
+            std::get<std::function<void(std::decay_t<E>&)>>(handlers_));
+    }
+
+    size_t size() const {
+        return std::apply([](const auto&... f) {
+            return (size_t(0) + ... + (f ? 1 : 0));
+        }, handlers_);
+    }
+
+private:
+    template <typename E>
+    std::function<void(std::decay_t<E>&)>& slot() {
+        return std::get<std::function<void(std::decay_t<E>&)>>(handlers_);
+    }
+
+    std::tuple<std::function<void(Events&)>...> handlers_;
+
+}; // class StaticEventMatcher
+
+} // namespace tab
+
+#endif // __STATIC_EVENT_MATCHER_HPP__
@@ -0,0 +1,143 @@
+#ifndef __TIMER_WHEEL_HPP__
+#define __TIMER_WHEEL_HPP__
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace tab {
+
+/**
+ * @brief A hierarchical timing wheel, whose timers are armed, cancelled
+ *        and expired in constant time. It is used by one thread, such as
+ *        a handler thread of 'TcpServer'.
+ *
+ * There are 'LEVELS' wheels of 'SLOTS' slots. A slot of level 0 holds the
+ * timers of one tick (a millisecond), and a slot of level L holds the ones
+ * of 'SLOTS'^L ticks, which are moved down to the lower levels when the
+ * time reaches the slot. The timers further than all the levels wait in
+ * the last slots of the top level, and are moved again when they are
+ * reached. The slots having timers are marked in a bitmap of each level,
+ * so the next tick to advance to is found without scanning the slots.
+ *
+ * @note It is not thread-safe. The timers are owned by the callers and
+ *       linked into the wheel, so arming one allocates nothing.
+ */
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    constexpr static unsigned LEVELS    = 4;
+    constexpr static unsigned SLOT_BITS = 6;
+    constexpr static unsigned SLOTS     = 1u << SLOT_BITS;
+
+private:
+    struct Link {
+        Link* prev = nullptr;
+        Link* next = nullptr;
+    };
+
+public:
+    class Timer : private Link {
+    public:
+        Timer() = default;
+
+        explicit Timer(std::function<void()> f) : callback(std::move(f)) { }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        // Cancelled if it is armed.
+        ~Timer() {
+            cancel();
+        }
+
+        bool armed() const noexcept {
+            return wheel_ != nullptr;
+        }
+
+        /**
+         * @brief Cancel it if it is armed, otherwise nothing is done.
+         */
+        void cancel() noexcept;
+
+        /**
+         * @brief Called in the thread of the wheel when the timer expires.
+         *        It is disarmed before, so it can be armed again here.
+         */
+        std::function<void()> callback;
+
+    private:
+        TimerWheel*        wheel_   = nullptr;
+        unsigned long long expires_ = 0; // in ticks
+        unsigned           slot_    = 0; // level * SLOTS + index
+
+        friend class TimerWheel;
+    }; // class Timer
+
+public:
+    TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // The timers still armed are disarmed without being called.
+    ~TimerWheel();
+
+    /**
+     * @brief Arm 'timer' to expire 'milliseconds' later. If it is armed
+     *        (in this or another wheel), it is moved.
+     */
+    void arm(Timer& timer, unsigned long long milliseconds);
+
+    /**
+     * @brief Call the timers which have expired by 'now'.
+     *
+     * @return How many timers expired.
+     */
+    size_t advance(Clock::time_point now);
+
+    size_t advance() {
+        return advance(Clock::now());
+    }
+
+    /**
+     * @brief Milliseconds until 'advance()' has something to do, which
+     *        may be earlier than the first timer expires, or -1 if no timer
+     *        is armed. It can be passed to epoll_wait() as the timeout.
+     */
+    int nextTimeout() const;
+
+    // The number of the timers armed.
+    size_t size() const noexcept {
+        return count_;
+    }
+
+private:
+    constexpr static unsigned long long NEVER = ~0ULL;
+
+    unsigned long long tickOf(Clock::time_point t) const;
+    // Put the armed timer into the slot for its expiry.
+    void link(Timer& timer);
+    void unlink(Timer& timer) noexcept;
+    // The next tick at which a slot having timers is reached, or 'NEVER'.
+    unsigned long long nextTick() const noexcept;
+    // Move the timers of the slot down to the lower levels.
+    void cascade(unsigned level, unsigned index);
+    size_t expire(unsigned index);
+
+    Clock::time_point  start_;
+    // The last tick which has been advanced to.
+    unsigned long long now_   = 0;
+    size_t             count_ = 0;
+    uint64_t           occupied_[LEVELS] = {};
+    // The heads of the circular lists of the slots.
+    Link               slots_[LEVELS * SLOTS];
+
+}; // class TimerWheel
+
+} // namespace tab
+
+#endif // __TIMER_WHEEL_HPP__
@@ -0,0 +1,102 @@
+#ifndef __SCAN_HPP__
+#define __SCAN_HPP__
+
+#include <cstddef>
+
+namespace tab {
+
+/**
+ * @brief Implementations of the scanning functions below.
+ *
+ * The best one supported by the CPU is chosen by the first call of each
+ * scanning function: AVX2 (64 bytes per step when finding one byte, 32 
+ * when finding either of two), SSE2 (16 bytes per step), or the plain 
+ * loop.
+ */
+enum class ScanKernel { SCALAR, SSE2, AVX2 };
+
+
+// Implemented in 'Scan.cpp', they call the chosen implementation.
+const char* ScanForLong(const char* begin, const char* end, char c) noexcept;
+const char* ScanForLong(const char* begin, const char* end,
+                        char a, char b) noexcept;
+
+// Ranges shorter than this are scanned inline, 
+// since they are not worth an indirect call.
+constexpr long SCAN_SHORT_LIMIT = 16;
+
+
+/**
+ * @brief Find the first byte equal to 'c' in ['begin', 'end').
+ *
+ * @return The position found, or 'end' if there is none.
+ */
+inline const char* ScanFor(const char* begin, const char* end,
+                           char c) noexcept {
+    if (end - begin >= SCAN_SHORT_LIMIT)
+        return ScanForLong(begin, end, c);
+    for (; begin < end; ++begin)
+        if (*begin == c)
+            return begin;
+    return end;
+}
+
+
+/**
+ * @brief Find the first byte equal to 'a' or 'b' in ['begin', 'end').
+ *
+ * @return The position found, or 'end' if there is none.
+ */
+inline const char* ScanFor(const char* begin, const char* end,
+                           char a, char b) noexcept {
+    if (end - begin >= SCAN_SHORT_LIMIT)
+        return ScanForLong(begin, end, a, b);
+    for (; begin < end; ++begin)
+        if (*begin == a || *begin == b)
+            return begin;
+    return end;
+}
+
+
+/**
+ * @brief Find the end of the line starting at 'begin', that is the first
+ *        '\r' or '\n' in ['begin', 'end').
+ *
+ * @return The position found, or 'end' if there is none.
+ */
+inline const char* ScanLineEnd(const char* begin, const char* end) noexcept {
+    return ScanFor(begin, end, '\r', '\n');
+}
+
+
+/**
+ * @brief Find the end of a head of HTTP messages at the beginning of
+ *        ['p', 'p' + 'len'), that is an empty line.
+ *
+ * @param from Where to start searching. If the head is not complete, it
+ *             is set to where to continue when more data come.
+ *
+ * @return The length of the head with the empty line, or 0 if it is not
+ *         complete.
+ */
+size_t FindHeadEnd(const char* p, size_t len, size_t& from) noexcept;
+
+
+/**
+ * @brief Get the implementation in use.
+ */
+ScanKernel GetScanKernel() noexcept;
+
+
+/**
+ * @brief Choose the implementation to use, mainly for testing.
+ *
+ * @return false if the CPU does not support it, and nothing is changed.
+ *
+ * @note It is not thread-safe, call it before any scanning.
+ */
+bool SetScanKernel(ScanKernel k) noexcept;
+
+} // namespace tab
+
+#endif // __SCAN_HPP__
@@ -2,6 +2,7 @@
 #define __TRANSFORM_HPP__
 
 #include <string>
+#include <string_view>
 
 namespace tab {
 
@@ -35,6 +36,14 @@ std::string& UppercaseToLower(std::string& str);
 std::string& LowercaseToUpper(std::string& str);
 
 
+/**
+ * @brief Compare two strings, ignoring the case of ASCII letters.
+ * 
+ * @return true if they are equal.
+ */
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) noexcept;
+
+
 /**
  * @brief Convert a number in string type to unsigned long long.
  * 
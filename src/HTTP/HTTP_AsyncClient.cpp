@@ -0,0 +1,613 @@
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "EzNet/HTTP/HTTP_AsyncClient.hpp"
+
+#ifdef _LINUX
+#  include <netinet/tcp.h>
+#  include <sys/epoll.h>
+#  include <sys/eventfd.h>
+#endif // _LINUX
+
+namespace tab {
+
+#ifdef _LINUX
+
+#define MAX_EPOLL_EVENTS   256
+#define LOOP_BUFFER_SIZE   65536
+
+namespace {
+
+// A request waiting for its response.
+struct AsyncJob {
+    HttpConnectionPool::Key    key;
+    Address                    addr;
+    std::string                data;
+    bool                       head = false;
+    HttpAsyncClient::Options   options;
+    HttpAsyncClient::Callback  callback;
+};
+
+void Finish(AsyncJob& job, std::exception_ptr error, HttpResponse& resp) {
+    try {
+        job.callback(error, resp);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "tab::HttpAsyncClient: The callback threw an exception, "
+                     "what(): " << e.what() << std::endl;
+    }
+    catch (...) {
+        std::cerr << "tab::HttpAsyncClient: The callback threw an exception."
+                  << std::endl;
+    }
+}
+
+void Fail(AsyncJob& job, const std::string& reason) {
+    HttpResponse empty;
+    Finish(job, std::make_exception_ptr(std::runtime_error(
+        "tab::HttpAsyncClient::request(): " + reason)), empty);
+}
+
+} // namespace
+
+
+class AsyncConnection {
+public:
+    enum class State { CONNECTING, SENDING, RECEIVING, IDLE };
+
+    AsyncConnection(HttpEventLoop& loop, HttpConnectionPool::Key key,
+                    socket_t fd) :
+        loop_(loop), key_(std::move(key)), fd_(fd) { }
+
+    ~AsyncConnection() {
+        if (fd_ >= 0)
+            _close(fd_);
+    }
+
+    // Start 'job' on an idle connection if 'allow_reuse', 
+    // or on a new one.
+    static void start(HttpEventLoop& loop, std::unique_ptr<AsyncJob> job,
+                      bool allow_reuse);
+
+    // Start 'job' on this connection.
+    void begin(std::unique_ptr<AsyncJob> job, bool reused, bool connecting);
+
+    void onEvents(uint32_t events);
+
+    // Give up the request for 'reason'. It is sent again on a new
+    // connection if this one was idle and the server said nothing.
+    void fail(const std::string& reason, bool may_retry = true);
+
+    void closeSocket() {
+        if (fd_ >= 0) {
+            _close(fd_);  // removed from the epoll set
+            fd_ = -1;
+        }
+    }
+
+    HttpEventLoop&           loop_;
+    HttpConnectionPool::Key  key_;
+    socket_t                 fd_;
+    State                    state_ = State::IDLE;
+    std::unique_ptr<AsyncJob> job_;
+    size_t                   sent_ = 0;
+    HttpResponseParser       parser_;
+    bool                     reused_ = false;
+    bool                     received_ = false;
+    bool                     has_deadline_ = false;
+    std::multimap<HttpEventLoop::Clock::time_point,
+                  AsyncConnection*>::iterator deadline_;
+
+private:
+    void send();
+    void receive();
+    void succeed(bool reusable);
+};
+
+
+void AsyncConnection::begin(std::unique_ptr<AsyncJob> job, bool reused,
+                            bool connecting) {
+    job_ = std::move(job);
+    reused_ = reused;
+    received_ = false;
+    sent_ = 0;
+    parser_.reset();
+    parser_.limits() = job_->options.limits;
+    parser_.setNoBody(job_->head);
+    loop_.setDeadline(this, job_->options.timeout_milliseconds);
+    if (connecting) {
+        state_ = State::CONNECTING;
+        loop_.watch(this, EPOLLOUT);
+    }
+    else {
+        state_ = State::SENDING;
+        send();
+    }
+}
+
+
+void AsyncConnection::onEvents(uint32_t events) {
+    switch (state_) {
+    case State::CONNECTING: {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &len) != 0)
+            err = errno;
+        if (err != 0) {
+            fail(std::string("Can not connect to the destination, ") +
+                 strerror(err) + ".");
+            return;
+        }
+        state_ = State::SENDING;
+        send();
+        break;
+    }
+    case State::SENDING:
+        send();
+        break;
+    case State::RECEIVING:
+        receive();
+        break;
+    case State::IDLE:
+        // Closed by the peer, or something unexpected came.
+        (void)events;
+        loop_.destroy(this);
+        break;
+    }
+}
+
+
+void AsyncConnection::send() {
+    auto& data = job_->data;
+    while (sent_ < data.size()) {
+        ssize_t n = ::send(fd_, data.data() + sent_, data.size() - sent_,
+                           MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                loop_.watch(this, EPOLLOUT);
+                return;
+            }
+            fail(std::string("Error(s) occurred while sending the request, ") +
+                 strerror(errno) + ".");
+            return;
+        }
+        sent_ += static_cast<size_t>(n);
+    }
+    state_ = State::RECEIVING;
+    loop_.watch(this, EPOLLIN | EPOLLRDHUP);
+}
+
+
+void AsyncConnection::receive() {
+    char* buffer = loop_.buffer_.get();
+    for (;;) {
+        ssize_t n = ::recv(fd_, buffer, LOOP_BUFFER_SIZE, 0);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return;
+            fail(std::string("Error(s) occurred while receiving "
+                             "the response, ") + strerror(errno) + ".");
+            return;
+        }
+        if (n == 0) {
+            auto status = parser_.finish();
+            if (status == HttpResponseParser::Status::COMPLETE)
+                succeed(false);
+            else
+                fail("The connection is closed before the response ends.");
+            return;
+        }
+        received_ = true;
+        size_t consumed = 0;
+        auto status = parser_.feed(buffer, static_cast<size_t>(n), consumed);
+        switch (status) {
+        case HttpResponseParser::Status::NEED_MORE:
+            break;
+        case HttpResponseParser::Status::COMPLETE:
+            // Nothing should follow the response, or the connection
+            // can not be used again.
+            succeed(consumed == static_cast<size_t>(n));
+            return;
+        case HttpResponseParser::Status::INVALID:
+            fail("The response is invalid.");
+            return;
+        case HttpResponseParser::Status::TOO_LARGE:
+            fail("The response is too large.");
+            return;
+        }
+    }
+}
+
+
+void AsyncConnection::succeed(bool reusable) {
+    loop_.cancelDeadline(this);
+    auto job = std::move(job_);
+    HttpResponse resp(std::move(parser_.response()));
+    if (reusable && parser_.reusable())
+        loop_.release(this, job->options.max_idle_per_host);
+    else
+        loop_.destroy(this);
+    Finish(*job, nullptr, resp);
+}
+
+
+void AsyncConnection::fail(const std::string& reason, bool may_retry) {
+    loop_.cancelDeadline(this);
+    auto job = std::move(job_);
+    bool retry = may_retry && reused_ && !received_ &&
+                 loop_.running_.load(std::memory_order_relaxed);
+    loop_.destroy(this);
+    if (!job)
+        return;
+    if (retry)
+        start(loop_, std::move(job), false);
+    else
+        Fail(*job, reason);
+}
+
+
+namespace {
+
+socket_t Connect(const Address& addr, bool& in_progress) {
+    socket_t fd = socket(addr.getAF(),
+                         SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                         IPPROTO_TCP);
+    if (fd < 0)
+        return -1;
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    auto sa = addr.get();
+    if (connect(fd, sa.get(), addr.getSize()) == 0) {
+        in_progress = false;
+        return fd;
+    }
+    if (errno == EINPROGRESS) {
+        in_progress = true;
+        return fd;
+    }
+    _close(fd);
+    return -1;
+}
+
+} // namespace
+
+
+void AsyncConnection::start(HttpEventLoop& loop, 
+                            std::unique_ptr<AsyncJob> job,
+                            bool allow_reuse) {
+    if (!loop.running_.load(std::memory_order_relaxed)) {
+        Fail(*job, "The loop is stopped.");
+        return;
+    }
+    if (allow_reuse) {
+        if (auto conn = loop.acquire(job->key)) {
+            conn->begin(std::move(job), true, false);
+            return;
+        }
+    }
+    bool in_progress = false;
+    socket_t fd = Connect(job->addr, in_progress);
+    if (fd < 0) {
+        Fail(*job, std::string("Can not connect to the destination, ") +
+                   strerror(errno) + ".");
+        return;
+    }
+    auto conn = new AsyncConnection(loop, job->key, fd);
+    loop.connections_.insert(conn);
+    epoll_event ev{};
+    ev.events   = 0;
+    ev.data.ptr = conn;
+    epoll_ctl(loop.epfd_, EPOLL_CTL_ADD, fd, &ev);
+    conn->begin(std::move(job), false, in_progress);
+}
+
+
+HttpEventLoop::HttpEventLoop() : buffer_(new char[LOOP_BUFFER_SIZE]) {
+    epfd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epfd_ < 0 || wake_fd_ < 0) {
+        if (epfd_ >= 0)
+            _close(epfd_);
+        if (wake_fd_ >= 0)
+            _close(wake_fd_);
+        throw std::runtime_error(
+            "tab::HttpEventLoop::HttpEventLoop(): "
+            "Failed to create the event loop.");
+    }
+    epoll_event ev{};
+    ev.events   = EPOLLIN;
+    ev.data.ptr = nullptr;
+    epoll_ctl(epfd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+    running_ = true;
+    thread_ = std::thread(&HttpEventLoop::run, this);
+}
+
+
+HttpEventLoop::~HttpEventLoop() {
+    stop();
+    _close(wake_fd_);
+    _close(epfd_);
+}
+
+
+void HttpEventLoop::post(std::function<void()> task) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopped_) {
+            lock.unlock();
+            task();
+            return;
+        }
+        tasks_.push_back(std::move(task));
+    }
+    uint64_t one = 1;
+    ssize_t n = write(wake_fd_, &one, sizeof(one));
+    (void)n;
+}
+
+
+void HttpEventLoop::stop() {
+    if (!running_.exchange(false))
+        return;
+    uint64_t one = 1;
+    ssize_t n = write(wake_fd_, &one, sizeof(one));
+    (void)n;
+    if (thread_.joinable())
+        thread_.join();
+}
+
+
+void HttpEventLoop::run() {
+    epoll_event events[MAX_EPOLL_EVENTS];
+    std::vector<std::function<void()>> tasks;
+    for (;;) {
+        int n = epoll_wait(epfd_, events, MAX_EPOLL_EVENTS, nextTimeout());
+        if (n < 0 && errno != EINTR) {
+            std::cerr
+                << "tab::HttpEventLoop::run(): epoll_wait() failed, error: "
+                << errno << "." << std::endl;
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            auto conn = (AsyncConnection*)events[i].data.ptr;
+            if (conn == nullptr) {
+                uint64_t count;
+                ssize_t r = read(wake_fd_, &count, sizeof(count));
+                (void)r;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    tasks.swap(tasks_);
+                }
+                for (auto& task : tasks)
+                    task();
+                tasks.clear();
+            }
+            else if (conn->fd_ >= 0) {
+                conn->onEvents(events[i].events);
+            }
+        }
+        expire();
+        for (auto conn : closed_)
+            delete conn;
+        closed_.clear();
+        if (!running_.load(std::memory_order_relaxed))
+            break;
+    }
+
+    // The requests posted or running fail.
+    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks.swap(tasks_);
+        stopped_ = true;
+    }
+    for (auto& task : tasks)
+        task();
+    std::vector<AsyncConnection*> all(connections_.begin(),
+                                      connections_.end());
+    for (auto conn : all) {
+        if (conn->job_)
+            conn->fail("The loop is stopped.", false);
+        else
+            destroy(conn);
+    }
+    for (auto conn : closed_)
+        delete conn;
+    closed_.clear();
+} // HttpEventLoop::run()
+
+
+void HttpEventLoop::watch(AsyncConnection* conn, uint32_t events) {
+    epoll_event ev{};
+    ev.events   = events;
+    ev.data.ptr = conn;
+    epoll_ctl(epfd_, EPOLL_CTL_MOD, conn->fd_, &ev);
+}
+
+
+void HttpEventLoop::setDeadline(AsyncConnection* conn, int milliseconds) {
+    cancelDeadline(conn);
+    if (milliseconds <= 0)
+        return;
+    conn->deadline_ = deadlines_.emplace(
+        Clock::now() + std::chrono::milliseconds(milliseconds), conn);
+    conn->has_deadline_ = true;
+}
+
+
+void HttpEventLoop::cancelDeadline(AsyncConnection* conn) {
+    if (conn->has_deadline_) {
+        deadlines_.erase(conn->deadline_);
+        conn->has_deadline_ = false;
+    }
+}
+
+
+int HttpEventLoop::nextTimeout() {
+    if (deadlines_.empty())
+        return -1;
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadlines_.begin()->first - Clock::now()).count();
+    // Rounded up, so that the deadline has passed when waking up.
+    return left < 0 ? 0 : static_cast<int>(left) + 1;
+}
+
+
+void HttpEventLoop::expire() {
+    auto now = Clock::now();
+    while (!deadlines_.empty() && deadlines_.begin()->first <= now) {
+        auto conn = deadlines_.begin()->second;
+        conn->fail("Timed out.", false);
+    }
+}
+
+
+AsyncConnection* HttpEventLoop::acquire(const HttpConnectionPool::Key& key) {
+    auto it = idle_.find(key);
+    if (it == idle_.end())
+        return nullptr;
+    auto& list = it->second;
+    AsyncConnection* ret = nullptr;
+    while (!list.empty() && ret == nullptr) {
+        // The newest is the least likely to be closed by the peer.
+        auto conn = list.back();
+        list.pop_back();
+        char c;
+        ssize_t n = ::recv(conn->fd_, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            ret = conn;
+        else
+            close(conn); // 'destroy()' may erase the list
+    }
+    if (list.empty())
+        idle_.erase(it);
+    return ret;
+}
+
+
+void HttpEventLoop::release(AsyncConnection* conn, size_t max_idle) {
+    if (max_idle == 0) {
+        destroy(conn);
+        return;
+    }
+    auto& list = idle_[conn->key_];
+    if (list.size() >= max_idle) {
+        // The oldest is closed, the list is still needed.
+        auto oldest = list.front();
+        list.erase(list.begin());
+        close(oldest);
+    }
+    conn->state_ = AsyncConnection::State::IDLE;
+    list.push_back(conn);
+    watch(conn, EPOLLIN | EPOLLRDHUP);
+}
+
+
+void HttpEventLoop::destroy(AsyncConnection* conn) {
+    if (conn->state_ == AsyncConnection::State::IDLE) {
+        auto it = idle_.find(conn->key_);
+        if (it != idle_.end()) {
+            auto& list = it->second;
+            for (size_t i = 0; i < list.size(); ++i) {
+                if (list[i] == conn) {
+                    list.erase(list.begin() + i);
+                    break;
+                }
+            }
+            if (list.empty())
+                idle_.erase(it);
+        }
+    }
+    close(conn);
+}
+
+
+void HttpEventLoop::close(AsyncConnection* conn) {
+    cancelDeadline(conn);
+    conn->closeSocket();
+    if (connections_.erase(conn) > 0)
+        closed_.push_back(conn);
+}
+
+#else // not _LINUX
+
+HttpEventLoop::HttpEventLoop() {
+    throw std::runtime_error(
+        "tab::HttpEventLoop::HttpEventLoop(): "
+        "It is only available on Linux.");
+}
+
+HttpEventLoop::~HttpEventLoop() { }
+
+void HttpEventLoop::post(std::function<void()>) { }
+
+void HttpEventLoop::stop() { }
+
+#endif // _LINUX
+
+
+HttpAsyncClient::HttpAsyncClient() :
+    loop_(std::make_shared<HttpEventLoop>()) { }
+
+
+HttpAsyncClient::HttpAsyncClient(std::shared_ptr<HttpEventLoop> loop) :
+    loop_(std::move(loop)) { }
+
+
+HttpAsyncClient::HttpAsyncClient(std::shared_ptr<HttpEventLoop> loop,
+                                 const Options& opt) :
+    loop_(std::move(loop)), options_(opt) { }
+
+
+void HttpAsyncClient::request(const URL& url, HttpRequest request,
+                              Callback callback) {
+    if (url.getProtocol() != URL::Protocol::HTTP) {
+        throw std::logic_error(
+            "tab::HttpAsyncClient::request(): "
+            "The protocol is not HTTP.");
+    }
+#ifdef _LINUX
+    std::unique_ptr<AsyncJob> job(new AsyncJob);
+    job->key      = HttpConnectionPool::Key(url);
+    job->addr     = url.getHost().getAddr();
+    job->head     = request.getMethod() == HTTP::REQ_HEAD;
+    job->options  = options_;
+    job->callback = std::move(callback);
+    request.setURI(url.getPath());
+    request.addHeader(HTTP::HOST, url.getHostName());
+    job->data     = request.getString();
+
+    // 'std::function' must be copyable.
+    auto raw = job.release();
+    HttpEventLoop* loop = loop_.get();
+    loop_->post([loop, raw]() {
+        AsyncConnection::start(*loop, std::unique_ptr<AsyncJob>(raw), true);
+    });
+#else
+    (void)request;
+    (void)callback;
+#endif // _LINUX
+}
+
+
+std::future<HttpResponse> HttpAsyncClient::request(const URL& url,
+                                                   HttpRequest request) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    auto ret = promise->get_future();
+    this->request(url, std::move(request),
+        [promise](std::exception_ptr error, HttpResponse& resp) {
+            if (error)
+                promise->set_exception(error);
+            else
+                promise->set_value(std::move(resp));
+        });
+    return ret;
+}
+
+} // namespace tab
@@ -0,0 +1,182 @@
+#include "EzNet/HTTP/HTTP_ChunkedDecoder.hpp"
+#include "EzNet/Utility/General/Scan.hpp"
+#include "EzNet/Utility/General/Transform.hpp"
+
+namespace tab {
+
+namespace {
+
+// Maximum length of a chunk size line, with the extensions.
+constexpr size_t MAX_SIZE_LINE = 4096;
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+
+ChunkedDecoder::Status ChunkedDecoder::decode(const char* data, size_t len,
+                                              size_t& consumed,
+                                              const Sink& sink) {
+    const char* p = data;
+    const char* end = data + len;
+    Status ret = Status::NEED_MORE;
+    std::string_view line;
+    while (ret == Status::NEED_MORE && state_ != State::DONE) {
+        switch (state_) {
+        case State::SIZE:
+            if (!takeLine(p, end, line)) {
+                if (line_.size() > MAX_SIZE_LINE)
+                    ret = Status::INVALID;
+                consumed = len;
+                return ret;
+            }
+            ret = onSizeLine(line);
+            break;
+
+        case State::DATA: {
+            // The payload is passed as it is in the fed data.
+            size_t n = remaining_ < static_cast<size_t>(end - p)
+                     ? remaining_ : static_cast<size_t>(end - p);
+            if (n > 0)
+                sink(p, n);
+            p += n;
+            remaining_ -= n;
+            body_size_ += n;
+            if (remaining_ > 0) {
+                consumed = len;
+                return Status::NEED_MORE;
+            }
+            state_ = State::DATA_END;
+            break;
+        }
+
+        case State::DATA_END:
+            if (!takeLine(p, end, line)) {
+                if (!line_.empty() && line_ != "\r")
+                    ret = Status::INVALID;
+                consumed = len;
+                return ret;
+            }
+            if (!line.empty())
+                ret = Status::INVALID;
+            state_ = State::SIZE;
+            break;
+
+        case State::TRAILER:
+            if (!takeLine(p, end, line)) {
+                if (trailer_size_ + line_.size() > max_trailer_size_)
+                    ret = Status::TOO_LARGE;
+                consumed = len;
+                return ret;
+            }
+            if (line.empty()) {
+                state_ = State::DONE;
+                break;
+            }
+            trailer_size_ += line.size();
+            if (trailer_size_ > max_trailer_size_)
+                ret = Status::TOO_LARGE;
+            else if (trailer_handler_)
+                trailer_handler_(line);
+            break;
+
+        case State::DONE:
+            break;
+        }
+    }
+    consumed = static_cast<size_t>(p - data);
+    return state_ == State::DONE && ret == Status::NEED_MORE
+         ? Status::COMPLETE : ret;
+} // ChunkedDecoder::decode()
+
+
+void ChunkedDecoder::reset() noexcept {
+    state_        = State::SIZE;
+    remaining_    = 0;
+    body_size_    = 0;
+    trailer_size_ = 0;
+    line_.clear();
+    line_taken_   = false;
+}
+
+
+// Only the last coding tells whether the body is chunked.
+bool ChunkedDecoder::IsChunked(std::string_view codings) noexcept {
+    auto comma = codings.rfind(',');
+    if (comma != std::string_view::npos)
+        codings.remove_prefix(comma + 1);
+    while (!codings.empty() && 
+           (codings.front() == ' ' || codings.front() == '\t'))
+        codings.remove_prefix(1);
+    while (!codings.empty() && 
+           (codings.back() == ' ' || codings.back() == '\t'))
+        codings.remove_suffix(1);
+    return EqualsIgnoreCase(codings, "chunked");
+}
+
+
+/**
+ * chunk = chunk-size [ chunk-ext ] CRLF chunk-data CRLF
+ * chunk-ext = *( BWS ";" BWS chunk-ext-name [ BWS "=" BWS chunk-ext-val ] )
+ */
+ChunkedDecoder::Status ChunkedDecoder::onSizeLine(std::string_view line) {
+    size_t size = 0, i = 0;
+    // Without a limit, the size must not overflow anyway.
+    size_t limit = max_body_size_ != 0 ? max_body_size_ : ~size_t(0) >> 4;
+    for (int v; i < line.size() && (v = HexValue(line[i])) >= 0; ++i) {
+        if (size > limit)
+            return Status::TOO_LARGE;
+        size = size * 16 + static_cast<size_t>(v);
+    }
+    if (i == 0 || (i < line.size() && line[i] != ';' &&
+                   line[i] != ' ' && line[i] != '\t'))
+        return Status::INVALID;
+    if (size == 0) {
+        state_ = State::TRAILER;
+        return Status::NEED_MORE;
+    }
+    if (max_body_size_ != 0 &&
+        (size > max_body_size_ || body_size_ + size > max_body_size_))
+        return Status::TOO_LARGE;
+    remaining_ = size;
+    state_ = State::DATA;
+    return Status::NEED_MORE;
+}
+
+
+bool ChunkedDecoder::takeLine(const char*& p, const char* end,
+                              std::string_view& line) {
+    if (line_taken_) {
+        line_.clear();
+        line_taken_ = false;
+    }
+    const char* nl = ScanFor(p, end, '\n');
+    if (nl == end) {
+        line_.append(p, end);
+        p = end;
+        return false;
+    }
+    if (line_.empty()) { // the whole line is in the fed data
+        line = std::string_view(p, static_cast<size_t>(nl - p));
+    }
+    else {
+        // 'line' refers to 'line_', which is cleared by the next call.
+        line_.append(p, nl);
+        line = line_;
+        line_taken_ = true;
+    }
+    p = nl + 1;
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    return true;
+}
+
+} // namespace tab
@@ -7,15 +7,20 @@ namespace tab{
 
 HttpSessionClient GetNewSession() {
 #ifdef EN_OPENSSL
-    SslContext ssl_ctx;
-    HttpSessionClient ret([ssl_ctx](af_t af, char ty){
-        if (ty == 1) // SecureSocket
-            return std::shared_ptr<Socket>(new SecureSocket(ssl_ctx, af));
+    // Shared by all the sessions, so are the TLS sessions kept for
+    // resumption.
+    static SslContext ssl_ctx;
+    HttpSessionClient ret([](af_t af, char ty, const std::string& host){
+        if (ty == 1) { // SecureSocket
+            auto s = std::make_shared<SecureSocket>(ssl_ctx, af);
+            s->setHostName(host);
+            return std::shared_ptr<Socket>(s);
+        }
         else  // Common StreamSocket
             return std::shared_ptr<Socket>(new StreamSocket(af));
     });
 #else
-    HttpSessionClient ret([](af_t af, char){
+    HttpSessionClient ret([](af_t af, char, const std::string&){
         return std::shared_ptr<Socket>(new StreamSocket(af));
     });
 #endif
@@ -23,7 +28,9 @@ HttpSessionClient GetNewSession() {
 }
 
 HttpSessionClient HttpClient::target(const URL& url) {
-    return GetNewSession().setURL(url);
+    auto session = GetNewSession();
+    session.pool_ = pool_;
+    return std::move(session.setURL(url));
 }
 
 } // namespace tab
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "EzNet/HTTP/HTTP_ConnectionPool.hpp"
+
+namespace tab {
+
+namespace {
+
+/**
+ * An idle connection has nothing to read, so if it is readable, the peer
+ * has closed it (or sent something unexpected), and it can not be used.
+ */
+bool Healthy(Socket* s) {
+    return !s->readable(0);
+}
+
+} // namespace
+
+
+std::shared_ptr<Socket> HttpConnectionPool::acquire(const Key& key) {
+    // Closed after unlocking.
+    std::deque<std::shared_ptr<Socket>> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    purgeLocked(now, dropped);
+    auto it = idle_.find(key);
+    if (it == idle_.end())
+        return nullptr;
+    auto& list = it->second;
+    std::shared_ptr<Socket> ret;
+    while (!list.empty() && !ret) {
+        // The newest is the least likely to be closed by the peer.
+        auto s = std::move(list.back().socket);
+        list.pop_back();
+        if (Healthy(s.get()))
+            ret = std::move(s);
+        else
+            dropped.push_back(std::move(s));
+    }
+    if (list.empty())
+        idle_.erase(it);
+    return ret;
+}
+
+
+void HttpConnectionPool::release(const Key& key,
+                                 std::shared_ptr<Socket> socket) {
+    if (!socket)
+        return;
+    std::deque<std::shared_ptr<Socket>> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    purgeLocked(now, dropped);
+    auto& list = idle_[key];
+    list.push_back({ std::move(socket), now });
+    while (list.size() > options_.max_per_host) {
+        dropped.push_back(std::move(list.front().socket));
+        list.pop_front();
+    }
+    if (list.empty())
+        idle_.erase(key);
+}
+
+
+void HttpConnectionPool::purge() {
+    std::deque<std::shared_ptr<Socket>> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    purgeLocked(Clock::now(), dropped);
+}
+
+
+void HttpConnectionPool::clear() {
+    std::map<Key, IdleList> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    dropped.swap(idle_);
+}
+
+
+size_t HttpConnectionPool::idleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t n = 0;
+    for (auto& i : idle_)
+        n += i.second.size();
+    return n;
+}
+
+
+size_t HttpConnectionPool::idleCount(const Key& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_.find(key);
+    return it == idle_.end() ? 0 : it->second.size();
+}
+
+
+void HttpConnectionPool::purgeLocked(
+    Clock::time_point now, std::deque<std::shared_ptr<Socket>>& dropped) {
+    auto deadline = now - std::chrono::seconds(options_.idle_timeout_seconds);
+    for (auto it = idle_.begin(); it != idle_.end();) {
+        auto& list = it->second;
+        while (!list.empty() && list.front().since <= deadline) {
+            dropped.push_back(std::move(list.front().socket));
+            list.pop_front();
+        }
+        if (list.empty())
+            it = idle_.erase(it);
+        else
+            ++it;
+    }
+}
+
+} // namespace tab
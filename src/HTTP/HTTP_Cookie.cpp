@@ -1,4 +1,5 @@
 #include "EzNet/HTTP/HTTP_Cookie.hpp"
+#include "EzNet/Utility/General/Scan.hpp"
 #include <iostream>
 namespace tab {
 namespace HTTP {
@@ -6,14 +7,20 @@ namespace HTTP {
 Cookie Cookie::parse(const std::string& raw) {
     Cookie ret;
     size_t i = 0;
+    // Move 'i' to the next 'c' at or after it, or to the end.
+    auto skip_to = [&raw, &i](char c) {
+        if (i < raw.size())
+            i = ScanFor(raw.data() + i, raw.data() + raw.size(), c) 
+                - raw.data();
+    };
     for (; i < raw.size() && raw[i] == ' '; ++i);
-    for (; i < raw.size() && raw[i] != '='; ++i);
+    skip_to('=');
     if (i == 0 || i >= raw.size())
         throw InvalidCookieExpressionException();
     size_t pos_equal = i;
     ret.key_.assign(raw.begin(), raw.begin() + i);
     
-    for (; i < raw.size() && raw[i] != ';'; ++i);
+    skip_to(';');
     ret.data_.value.assign(raw.begin() + pos_equal + 1, raw.begin() + i);
     ++i;
     for (; i < raw.size() && raw[i] == ' '; ++i);
@@ -24,10 +31,10 @@ Cookie Cookie::parse(const std::string& raw) {
         switch (raw[i]) {
             case 'e':
             case 'E': { // Expires
-                for (; i < raw.size() && raw[i] != '='; ++i);
+                skip_to('=');
                 ++i;
                 size_t begin_expire = i;
-                for (; i < raw.size() && raw[i] != ';'; ++i);
+                skip_to(';');
                 size_t end_expire = i;
                 if (begin_expire >= raw.size() || begin_expire == end_expire)
                     throw InvalidCookieExpressionException();
@@ -41,7 +48,7 @@ Cookie Cookie::parse(const std::string& raw) {
                     throw InvalidCookieExpressionException();
                 switch (raw[i+1]) {
                     case 'a': // SameSite
-                        for (; i < raw.size() && raw[i] != '='; ++i);
+                        skip_to('=');
                         ++i;
                         if (i >= raw.size())
                             throw InvalidCookieExpressionException();
@@ -51,11 +58,11 @@ Cookie Cookie::parse(const std::string& raw) {
                             ret.data_.same_site = SameSite::Lax;
                         else
                             ret.data_.same_site = SameSite::None;
-                        for (; i < raw.size() && raw[i] != ';'; ++i);
+                        skip_to(';');
                         break;
                     case 'e': // Secure
                         ret.data_.secure = true;
-                        for (; i < raw.size() && raw[i] != ';'; ++i);
+                        skip_to(';');
                         break;
                     default:
                         throw InvalidCookieExpressionException();
@@ -65,12 +72,12 @@ Cookie Cookie::parse(const std::string& raw) {
             }
             case 'd': // fallthrough
             case 'D': { // Domain
-                for (; i < raw.size() && raw[i] != '='; ++i);
+                skip_to('=');
                 ++i;
                 if (i >= raw.size())
                     throw InvalidCookieExpressionException();
                 size_t begin_domain = i;
-                for (; i < raw.size() && raw[i] != ';'; ++i);
+                skip_to(';');
                 if (begin_domain >= i)
                     throw InvalidCookieExpressionException();
                 ret.data_.domain.assign(raw.begin() + begin_domain, 
@@ -79,12 +86,12 @@ Cookie Cookie::parse(const std::string& raw) {
             }
             case 'p': // fallthrough
             case 'P': { // Path
-                for (; i < raw.size() && raw[i] != '='; ++i);
+                skip_to('=');
                 ++i;
                 if (i >= raw.size())
                     throw InvalidCookieExpressionException();
                 size_t begin_path = i;
-                for (; i < raw.size() && raw[i] != ';'; ++i);
+                skip_to(';');
                 if (begin_path == i)
                     throw InvalidCookieExpressionException();
                 ret.data_.path.assign(raw.begin() + begin_path, 
@@ -93,17 +100,17 @@ Cookie Cookie::parse(const std::string& raw) {
             }
             case 'h': // fallthrough
             case 'H': { // HttpOnly
-                for (; i < raw.size() && raw[i] != ';'; ++i);
+                skip_to(';');
                 break;
             }
             case 'm': // fallthrough
             case 'M': { // Max-Age
-                for (; i < raw.size() && raw[i] != '='; ++i);
+                skip_to('=');
                 ++i;
                 if (i >= raw.size())
                     throw InvalidCookieExpressionException();
                 size_t begin_ma = i;
-                for (; i < raw.size() && raw[i] != ';'; ++i);
+                skip_to(';');
                 if (begin_ma == i)
                     throw InvalidCookieExpressionException();
                 ret.data_.max_age.assign(raw.begin() + begin_ma, 
@@ -112,10 +119,10 @@ Cookie Cookie::parse(const std::string& raw) {
             }
             default: {
                 auto temp = i;
-                for (; i < raw.size() && raw[i] != '='; ++i);
+                skip_to('=');
                 std::string unknown_key(raw.begin() + temp, raw.begin() + i);
                 temp = i;
-                for (; i < raw.size() && raw[i] != ';'; ++i);
+                skip_to(';');
                 std::pair<std::string, std::string> dat(
                     std::move(unknown_key),
                     std::move(
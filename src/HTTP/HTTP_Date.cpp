@@ -0,0 +1,75 @@
+#include <cstring>
+
+#include "EzNet/HTTP/HTTP_Date.hpp"
+#include "EzNet/Basic/platform.h"
+
+namespace tab {
+
+namespace HTTP {
+
+namespace {
+
+const char* const DAY_NAMES[] = {
+    "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+};
+
+const char* const MONTH_NAMES[] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", 
+    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+char* PutTwoDigits(char* p, int value) {
+    p[0] = static_cast<char>('0' + value / 10 % 10);
+    p[1] = static_cast<char>('0' + value % 10);
+    return p + 2;
+}
+
+char* PutName(char* p, const char* name) {
+    p[0] = name[0];
+    p[1] = name[1];
+    p[2] = name[2];
+    return p + 3;
+}
+
+} // namespace
+
+void FormatDate(std::time_t time, char* out) noexcept {
+    std::tm tm{};
+#ifdef _WINDOWS
+    gmtime_s(&tm, &time);
+#else
+    gmtime_r(&time, &tm);
+#endif
+    char* p = PutName(out, DAY_NAMES[tm.tm_wday % 7]);
+    *p++ = ',';
+    *p++ = ' ';
+    p = PutTwoDigits(p, tm.tm_mday);
+    *p++ = ' ';
+    p = PutName(p, MONTH_NAMES[tm.tm_mon % 12]);
+    *p++ = ' ';
+    int year = tm.tm_year + 1900;
+    p = PutTwoDigits(p, year / 100);
+    p = PutTwoDigits(p, year % 100);
+    *p++ = ' ';
+    p = PutTwoDigits(p, tm.tm_hour);
+    *p++ = ':';
+    p = PutTwoDigits(p, tm.tm_min);
+    *p++ = ':';
+    p = PutTwoDigits(p, tm.tm_sec);
+    std::memcpy(p, " GMT", 4);
+}
+
+const char* CurrentDate() noexcept {
+    thread_local std::time_t formatted = -1;
+    thread_local char date[DATE_LENGTH];
+    std::time_t now = std::time(nullptr);
+    if (now != formatted) {
+        FormatDate(now, date);
+        formatted = now;
+    }
+    return date;
+}
+
+} // namespace HTTP
+
+} // namespace tab
@@ -1,13 +1,15 @@
+#include <cstdint>
 #include <exception>
 #include <stdexcept>
 
 #include "EzNet/HTTP/HTTP_Header.hpp"
+#include "EzNet/Utility/General/Scan.hpp"
 
 namespace tab {
 
 namespace HTTP {
     
-const char* HeaderKeyName[]{
+constexpr const char* const HeaderKeyName[]{
     "",
     "Accept",
     "Accept-CH",
@@ -101,13 +103,76 @@ const char* HeaderKeyName[]{
 constexpr static size_t HeaderFieldCount 
     = sizeof(HeaderKeyName) / sizeof(const char*);
 
-HeaderFieldName HeaderFieldStringToEnum(const std::string& str) {
-    const char** pos 
-        = std::find(HeaderKeyName, HeaderKeyName + HeaderFieldCount, str);
-    if (pos != HeaderKeyName + HeaderFieldCount)
-        return HeaderFieldName(pos - HeaderKeyName);
-    else
+namespace {
+
+// The names contain letters, digits and '-' only, so setting the bit
+// 0x20 makes them lower case without changing the others. A name with
+// other characters may get the hash of a known one, but it is compared 
+// before being accepted.
+constexpr uint32_t HashName(const char* p, size_t len, uint32_t seed) {
+    uint32_t h = seed;
+    for (size_t i = 0; i < len; ++i)
+        h = (h ^ static_cast<unsigned char>(p[i] | 0x20)) * 16777619u;
+    return h ^ (h >> 15);
+}
+
+constexpr size_t NameLength(const char* p) {
+    size_t len = 0;
+    while (p[len] != '\0')
+        ++ len;
+    return len;
+}
+
+// 1024 slots for less than 100 names, so a seed without collisions 
+// is found after a few dozen tries.
+constexpr size_t HASH_SLOTS = 1024;
+
+struct NameTable {
+    uint32_t seed = 0;
+    uint8_t  slots[HASH_SLOTS] = {};  // HeaderFieldName, 0 for empty slots
+    uint8_t  lengths[HeaderFieldCount] = {};
+};
+
+constexpr NameTable MakeNameTable() {
+    static_assert(HeaderFieldCount < 256, "HeaderFieldName must fit a byte.");
+    NameTable ret;
+    for (size_t i = 0; i < HeaderFieldCount; ++i)
+        ret.lengths[i] = static_cast<uint8_t>(NameLength(HeaderKeyName[i]));
+    for (uint32_t seed = 2166136261u; ; ++seed) {
+        for (auto& slot : ret.slots)
+            slot = 0;
+        bool collided = false;
+        for (size_t i = 1; i < HeaderFieldCount && !collided; ++i) {
+            auto& slot = ret.slots[
+                HashName(HeaderKeyName[i], ret.lengths[i], seed) % HASH_SLOTS];
+            if (slot != 0)
+                collided = true;
+            slot = static_cast<uint8_t>(i);
+        }
+        if (!collided) {
+            ret.seed = seed;
+            return ret;
+        }
+    }
+}
+
+constexpr NameTable NameTableValue = MakeNameTable();
+
+} // namespace
+
+HeaderFieldName HeaderFieldStringToEnum(std::string_view name) noexcept {
+    size_t i = NameTableValue.slots[
+        HashName(name.data(), name.size(), NameTableValue.seed) % HASH_SLOTS];
+    if (i == 0 || NameTableValue.lengths[i] != name.size())
         return NONE;
+    const char* key = HeaderKeyName[i];
+    for (size_t j = 0; j < name.size(); ++j) {
+        char a = name[j], b = key[j];
+        if (a != b && ((a | 0x20) != (b | 0x20) || 
+                       (a | 0x20) < 'a' || (a | 0x20) > 'z'))
+            return NONE;
+    }
+    return HeaderFieldName(i);
 }
 
 class NullHeader : public HeaderBase {
@@ -191,9 +256,7 @@ Header Header::parse(const char* raw, size_t len) {
     size_t i = 0;
     Header ret;
 
-    for (; i < len; ++i)
-        if (raw[i] == ':')
-            break;
+    i = ScanFor(raw, raw + len, ':') - raw;
     std::string key_name(raw, raw + i);
     auto header_name = HeaderFieldStringToEnum(key_name);
     std::string* value_ptr = nullptr;
@@ -213,11 +276,10 @@ Header Header::parse(const char* raw, size_t len) {
     for (++i; i < len; ++i)
         if (raw[i] != ' ')
             break;
-    size_t offset = 0;
-    for (size_t j = len; j >= i; --j)
-        if (raw[j] == '\r')
-            offset = len - j;
-    *value_ptr = std::move(std::string(raw + i, raw + len - offset)); 
+    if (i > len)
+        i = len;
+    auto value_end = ScanFor(raw + i, raw + len, '\r');
+    *value_ptr = std::move(std::string(raw + i, value_end)); 
 
     return ret;
 }
@@ -241,44 +303,115 @@ std::string CommonHeader::getString(void) const {
     return ret;
 }
 
+Headers& Headers::operator=(Headers&& val) noexcept {
+    if (this == &val)
+        return *this;
+    for (size_t i = 0; i < INLINE_CAPACITY; ++i) {
+        inline_[i].key = val.inline_[i].key;
+        inline_[i].name.swap(val.inline_[i].name);
+        inline_[i].value.swap(val.inline_[i].value);
+    }
+    more_.swap(val.more_);
+    count_ = val.count_;
+    std::memcpy(slots_, val.slots_, sizeof(slots_));
+    val.count_ = 0;
+    std::memset(val.slots_, 0, sizeof(val.slots_));
+    return *this;
+}
+
 std::string Headers::getStr(void) const {
-    try {
-        std::string ret;
-        for (auto i = map_common_.begin(); i != map_common_.end(); ++i)
-            ret.append(
-                std::string(HeaderKeyName[i->first])
-                 + ": " + i->second + "\r\n");
-        for (auto i = map_unknown_.begin(); i != map_unknown_.end(); ++i)
-            ret.append(i->first + ": " + i->second + "\r\n");
-        return ret;
+    std::string ret;
+    appendTo(ret);
+    return ret;
+}
+
+void Headers::appendTo(std::string& out) const {
+    size_t size = out.size();
+    for (size_t i = 0; i < count_; ++i) {
+        auto& field = at(i);
+        size += (field.key != NONE ? std::strlen(HeaderKeyName[field.key]) 
+                                   : field.name.size()) 
+              + field.value.size() + 4;
     }
-    catch (...) {
-        return "";
+    out.reserve(size);
+    for (size_t i = 0; i < count_; ++i) {
+        auto& field = at(i);
+        if (field.key != NONE)
+            out.append(HeaderKeyName[field.key]);
+        else
+            out.append(field.name);
+        out.append(": ", 2);
+        out.append(field.value);
+        out.append("\r\n", 2);
     }
 }
 
+Headers::Field& Headers::append(HeaderFieldName key) {
+    Field* field;
+    if (count_ < INLINE_CAPACITY)
+        field = &inline_[count_];
+    else if (count_ - INLINE_CAPACITY < more_.size())
+        field = &more_[count_ - INLINE_CAPACITY];
+    else
+        field = &more_.emplace_back();
+    ++ count_;
+    field->key = key;
+    field->name.clear();
+    field->value.clear();
+    return *field;
+}
+
+void Headers::erase(size_t i) {
+    if (slots_[at(i).key] == i + 1)
+        slots_[at(i).key] = 0;
+    for (size_t j = i + 1; j < count_; ++j) {
+        auto& from = at(j);
+        auto& to = at(j - 1);
+        to.key = from.key;
+        to.name.swap(from.name);
+        to.value.swap(from.value);
+        if (slots_[to.key] == j + 1)
+            slots_[to.key] = static_cast<uint16_t>(j);
+    }
+    -- count_;
+}
+
+std::string& Headers::valueOf(HeaderFieldName key) {
+    if (slots_[key] != 0)
+        return at(slots_[key] - 1).value;
+    auto& field = append(key);
+    slots_[key] = static_cast<uint16_t>(count_);
+    return field.value;
+}
+
+std::string& Headers::valueOf(std::string_view name) {
+    size_t i = indexOf(name);
+    if (i != count_)
+        return at(i).value;
+    auto& field = append(NONE);
+    field.name.assign(name);
+    return field.value;
+}
+
+size_t Headers::indexOf(std::string_view name) const noexcept {
+    for (size_t i = 0; i < count_; ++i) {
+        auto& field = at(i);
+        if (field.key == NONE && field.name == name)
+            return i;
+    }
+    return count_;
+}
+
 Headers& Headers::addHeader(const Header& header) {
     if (header.type() == Header::Type::Common) {
         auto&& ref = static_cast<const CommonHeader&>(*header.ptr_);
-        if (ref.getKey() == NONE)
-            return *this;
-
-        auto&& ite = map_common_.find(ref.getKey());
-        if (ite != map_common_.end())
-            ite->second = ref.getValue();
-        else
-            map_common_.insert(ref.getPair());
+        if (ref.getKey() != NONE)
+            valueOf(ref.getKey()) = ref.value_;
     }
     else if (header.type() == Header::Type::Unknown) {
         auto&& ref = static_cast<const UnknownHeader&>(*header.ptr_);
-        if (ref.getKey().empty())
-            return *this;
-
-        auto&& ite = map_unknown_.find(ref.getKey());
-        if (ite != map_unknown_.end())
-            ite->second = ref.getValue();
-        else
-            map_unknown_.insert({ref.getKey(), ref.getValue()});
+        if (!ref.key_.empty())
+            valueOf(ref.key_) = ref.value_;
     }
     else {
         throw std::logic_error("");
@@ -288,29 +421,14 @@ Headers& Headers::addHeader(const Header& header) {
 
 Headers& Headers::addHeader(Header&& header) {
     if (header.type() == Header::Type::Common) {
-        auto&& ref = std::move(header.to<CommonHeader>());
-        if (ref.getKey() == NONE)
-            return *this;
-
-        auto&& ite = map_common_.find(ref.getKey());
-        if (ite != map_common_.end())
-            ite->second = std::move(ref.value_);
-        else
-            map_common_.insert(
-                std::move(std::pair<HeaderFieldName, std::string>({
-                    ref.key_, std::move(ref.value_)})));
+        auto&& ref = header.to<CommonHeader>();
+        if (ref.getKey() != NONE)
+            valueOf(ref.getKey()) = std::move(ref.value_);
     }
     else if (header.type() == Header::Type::Unknown) {
-        auto&& ref = std::move(header.to<UnknownHeader>());
-        if (ref.getKey().empty())
-            return *this;
-            
-        auto&& ite = map_unknown_.find(ref.getKey());
-        if (ite != map_unknown_.end())
-            ite->second = std::move(ref.value_);
-        else
-            map_unknown_.insert(std::move(std::pair<std::string, std::string>({
-                std::move(ref.key_), std::move(ref.value_)})));
+        auto&& ref = header.to<UnknownHeader>();
+        if (!ref.key_.empty())
+            valueOf(ref.key_) = std::move(ref.value_);
     }
     else {
         throw std::logic_error("");
@@ -319,15 +437,8 @@ Headers& Headers::addHeader(Header&& header) {
 }
 
 Headers& Headers::addHeader(HeaderFieldName key, const std::string& value) {
-    if (key == NONE)
-        return *this;
-
-    auto&& ite = map_common_.find(key);
-    if (ite != map_common_.end())
-        ite->second = value;
-    else
-        map_common_.insert({key, value});
-    
+    if (key != NONE)
+        valueOf(key) = value;
     return *this;
 }
 
@@ -335,73 +446,58 @@ Headers& Headers::addHeader(const std::string& key, const std::string& value) {
     if (key.empty()) 
         return *this;
     auto header_name = HeaderFieldStringToEnum(key);
-    if (header_name != NONE) {
-        auto&& ite = map_common_.find(header_name);
-        if (ite != map_common_.end())
-            ite->second = value;
-        else
-            map_common_.insert({header_name, value});
-    }
-    else {
-        auto&& ite = map_unknown_.find(key);
-        if (ite != map_unknown_.end())
-            ite->second = value;
-        else
-            map_unknown_.insert({key, value});
-    }
-    
+    if (header_name != NONE)
+        valueOf(header_name) = value;
+    else
+        valueOf(key) = value;
     return *this;
 }
 
-std::string Headers::find(HeaderFieldName key) {
-    if (key == NONE)
-        return std::string();
-    auto&& ite = map_common_.find(key);
-    if (ite != map_common_.end())
-        return ite->second;
+Headers& Headers::addField(const char* raw, size_t len) {
+    auto colon = ScanFor(raw, raw + len, ':');
+    std::string_view key(raw, static_cast<size_t>(colon - raw));
+    if (key.empty())
+        return *this;
+    auto value = colon < raw + len ? colon + 1 : colon;
+    while (value < raw + len && *value == ' ')
+        ++ value;
+    auto value_end = ScanFor(value, raw + len, '\r');
+
+    auto header_name = HeaderFieldStringToEnum(key);
+    if (header_name != NONE)
+        valueOf(header_name).assign(value, value_end);
     else
+        valueOf(key).assign(value, value_end);
+    return *this;
+}
+
+std::string Headers::find(HeaderFieldName key) {
+    if (key == NONE || slots_[key] == 0)
         return std::string();
+    return at(slots_[key] - 1).value;
 }
 
 std::string Headers::find(const std::string& key) {
     auto header_name = HeaderFieldStringToEnum(key);
-    if (header_name != NONE) {
-        auto&& ite = map_common_.find(header_name);
-        if (ite != map_common_.end())
-            return ite->second;
-        else
-            return std::string();
-    }
-    else {
-        auto&& ite = map_unknown_.find(key);
-        if (ite != map_unknown_.end())
-            return ite->second;
-        else
-            return std::string();
-    }
+    if (header_name != NONE)
+        return find(header_name);
+    size_t i = indexOf(key);
+    return i != count_ ? at(i).value : std::string();
 }
 
 Headers& Headers::remove(const HeaderFieldName& key) {
-    if (key == NONE)
-        return *this;
-    auto&& ite = map_common_.find(key);
-    if (ite != map_common_.end())
-        map_common_.erase(ite);
+    if (key != NONE && slots_[key] != 0)
+        erase(slots_[key] - 1);
     return *this;
 }
 
 Headers& Headers::remove(const std::string& key) {
     auto header_name = HeaderFieldStringToEnum(key);
-    if (header_name != NONE) {
-        auto&& ite = map_common_.find(header_name);
-        if (ite != map_common_.end())
-            map_common_.erase(ite);
-    }
-    else {
-        auto&& ite = map_unknown_.find(key);
-        if (ite != map_unknown_.end())
-            map_unknown_.erase(ite);
-    }
+    if (header_name != NONE)
+        return remove(header_name);
+    size_t i = indexOf(key);
+    if (i != count_)
+        erase(i);
     return *this;
 }
 
@@ -1,6 +1,7 @@
 #include <algorithm>
 
 #include "EzNet/HTTP/HTTP_Request.hpp"
+#include "EzNet/Utility/General/Scan.hpp"
 
 namespace tab {
 
@@ -27,17 +28,15 @@ RequestLine RequestLine::parse(const std::string& raw) {
     RequestLine ret;
     
     // Get the method.
-    for (; i < limit; ++i) {
-        if (raw[i] == ' ') {
-            std::string&& method = std::string(raw.begin(), raw.begin() + i);
-            const char** pos
-                = find(ReqName, 
-                       ReqName + sizeof(ReqName) / sizeof(const char*),
-                       method);
-            if (pos != ReqName + sizeof(ReqName) / sizeof(const char*))
-                ret.method_ = ReqMethod(pos - ReqName);
-            break;
-        }
+    i = ScanFor(raw.data(), raw.data() + limit, ' ') - raw.data();
+    if (i < limit) {
+        std::string&& method = std::string(raw.begin(), raw.begin() + i);
+        const char** pos
+            = find(ReqName, 
+                   ReqName + sizeof(ReqName) / sizeof(const char*),
+                   method);
+        if (pos != ReqName + sizeof(ReqName) / sizeof(const char*))
+            ret.method_ = ReqMethod(pos - ReqName);
     }
 
     for (; i < limit; ++i)
@@ -54,9 +53,7 @@ RequestLine RequestLine::parse(const std::string& raw) {
             break;
         }
     }
-    for (j = i; j < limit; ++j)
-        if (raw[j] == '\r')
-            break;
+    j = ScanFor(raw.data() + i, raw.data() + limit, '\r') - raw.data();
     ret.version_ = std::move(std::string(raw.begin() + i, raw.begin() + j));
 
     ret.empty_ = false;
@@ -100,18 +97,17 @@ HttpRequest HttpRequest::parse(const void* raw, size_t len) {
     auto content_ptr = static_cast<const char*>(raw);
     
     
-    for (; i < len; ++i)
-        if (content_ptr[i] == '\r')
-            break;
+    i = ScanFor(content_ptr, content_ptr + len, '\r') - content_ptr;
     HttpRequest ret(std::move(
         HTTP::RequestLine::parse(std::string(content_ptr, content_ptr + i))));
 
     for (i += 2, j = i; j < len; ++j) {
-        if (content_ptr[j] == '\r') {
-            std::string&& line = std::string(content_ptr + i, content_ptr + j);
+        j = ScanFor(content_ptr + j, content_ptr + len, '\r') - content_ptr;
+        if (j < len) {
+            size_t line = i;
             i = j + 2;
-            if (!line.empty()) {
-                ret.addHeader(HTTP::Header::parse(line));
+            if (j > line) {
+                ret.headers_.addField(content_ptr + line, j - line);
                 ++j;
             }
             else {
@@ -130,7 +126,7 @@ HttpRequest HttpRequest::parse(const void* raw, size_t len) {
 std::string HttpRequest::getString(void) const {
     std::string ret;
     ret.append(request_.get());
-    ret.append(headers_.getStr());
+    headers_.appendTo(ret);
     if (cookies_.size() > 0)
         ret.append(cookies_.getUploadString());
     ret.append("\r\n");
@@ -141,7 +137,7 @@ std::string HttpRequest::getString(void) const {
 Buffer HttpRequest::getBuffer(void) const {
     std::string str;
     str.append(request_.get());
-    str.append(headers_.getStr());
+    headers_.appendTo(str);
     if (cookies_.size() > 0)
         str.append(cookies_.getUploadString());
     str.append("\r\n");
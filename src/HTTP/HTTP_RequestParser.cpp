@@ -0,0 +1,176 @@
+#include "EzNet/HTTP/HTTP_RequestParser.hpp"
+#include "EzNet/Utility/General/Scan.hpp"
+
+namespace tab {
+
+HttpRequestParser::Status HttpRequestParser::feed(const char* data,
+                                                  size_t len,
+                                                  size_t& consumed) {
+    const char* p = data;
+    const char* end = data + len;
+    for (;;) {
+        Status ret = Status::NEED_MORE;
+        switch (state_) {
+        case State::HEAD:
+            ret = parseHead(p, end);
+            break;
+
+        case State::BODY: {
+            size_t n = remaining_ < static_cast<size_t>(end - p)
+                     ? remaining_ : static_cast<size_t>(end - p);
+            if (in_place_ && n == remaining_ && !sink_) {
+                // The whole request is in the fed data.
+                view_.body_ = std::string_view(p, n);
+                p += n;
+                state_ = State::DONE;
+                break;
+            }
+            emitBody(p, n);
+            p += n;
+            remaining_ -= n;
+            if (remaining_ == 0) {
+                view_.body_ = std::string_view(body_);
+                state_ = State::DONE;
+            }
+            break;
+        }
+
+        case State::CHUNKED: {
+            size_t n = 0;
+            auto status = chunked_.decode(p, static_cast<size_t>(end - p), n,
+                [this](const char* data, size_t len) { emitBody(data, len); });
+            p += n;
+            if (status == ChunkedDecoder::Status::INVALID) {
+                ret = Status::INVALID;
+            }
+            else if (status == ChunkedDecoder::Status::TOO_LARGE) {
+                ret = Status::TOO_LARGE;
+            }
+            else if (status == ChunkedDecoder::Status::COMPLETE) {
+                view_.body_ = sink_ ? std::string_view()
+                                    : std::string_view(body_);
+                state_ = State::DONE;
+            }
+            break;
+        }
+
+        case State::DONE:
+            consumed = static_cast<size_t>(p - data);
+            return Status::COMPLETE;
+        }
+
+        if (ret != Status::NEED_MORE) {
+            consumed = static_cast<size_t>(p - data);
+            return ret;
+        }
+        if (p == end && state_ != State::DONE) {
+            // The fed data will be gone, keep what the view refers to.
+            keepHead();
+            consumed = len;
+            return Status::NEED_MORE;
+        }
+    }
+} // HttpRequestParser::feed()
+
+
+void HttpRequestParser::reset() noexcept {
+    state_     = State::HEAD;
+    head_.clear();
+    head_scan_ = 0;
+    in_place_  = false;
+    body_.clear();
+    body_size_ = 0;
+    remaining_ = 0;
+    chunked_.reset();
+}
+
+
+HttpRequestParser::Status HttpRequestParser::parseHead(const char*& p,
+                                                       const char* end) {
+    size_t len = static_cast<size_t>(end - p);
+    if (head_.empty()) {
+        // Parse in place if the whole head is here, which is the usual case.
+        size_t from = 0;
+        size_t n = FindHeadEnd(p, len, from);
+        if (n == 0) {
+            if (len > limits_.max_head_size)
+                return Status::TOO_LARGE;
+            head_.assign(p, len);
+            head_scan_ = from;
+            p = end;
+            return Status::NEED_MORE;
+        }
+        if (n > limits_.max_head_size)
+            return Status::TOO_LARGE;
+        if (view_.parse(p, n) != HttpRequestView::ParseStatus::OK)
+            return Status::INVALID;
+        in_place_ = true;
+        p += n;
+        return startBody();
+    }
+
+    size_t old = head_.size();
+    head_.append(p, len);
+    size_t n = FindHeadEnd(head_.data(), head_.size(), head_scan_);
+    if (n == 0) {
+        if (head_.size() > limits_.max_head_size)
+            return Status::TOO_LARGE;
+        p = end;
+        return Status::NEED_MORE;
+    }
+    if (n > limits_.max_head_size)
+        return Status::TOO_LARGE;
+    head_.resize(n);
+    p += n - old;
+    if (view_.parse(head_.data(), n) != HttpRequestView::ParseStatus::OK)
+        return Status::INVALID;
+    in_place_ = false;
+    return startBody();
+}
+
+
+HttpRequestParser::Status HttpRequestParser::startBody() {
+    if (view_.isChunked()) {
+        // The trailer fields are skipped, and limited like the head.
+        chunked_.setMaxBodySize(limits_.max_body_size);
+        chunked_.setMaxTrailerSize(limits_.max_head_size);
+        state_ = State::CHUNKED;
+    }
+    else if (view_.has("Transfer-Encoding")) {
+        // The length of the body is unknown.
+        return Status::INVALID;
+    }
+    else if (view_.contentLength() > 0) {
+        if (view_.contentLength() > limits_.max_body_size)
+            return Status::TOO_LARGE;
+        remaining_ = view_.contentLength();
+        state_ = State::BODY;
+    }
+    else {
+        state_ = State::DONE;
+    }
+    return Status::NEED_MORE;
+}
+
+
+void HttpRequestParser::emitBody(const char* p, size_t n) {
+    if (n == 0)
+        return;
+    if (sink_)
+        sink_(p, n);
+    else
+        body_.append(p, n);
+    body_size_ += n;
+}
+
+
+void HttpRequestParser::keepHead() {
+    if (!in_place_)
+        return;
+    const char* raw = view_.getMethodName().data();
+    head_.assign(raw, view_.headSize());
+    view_.parse(head_.data(), head_.size());
+    in_place_ = false;
+}
+
+} // namespace tab
@@ -0,0 +1,172 @@
+#include <cstring>
+
+#include "EzNet/HTTP/HTTP_ChunkedDecoder.hpp"
+#include "EzNet/HTTP/HTTP_RequestView.hpp"
+#include "EzNet/Utility/General/Scan.hpp"
+#include "EzNet/Utility/General/Transform.hpp"
+
+namespace tab {
+
+namespace {
+
+constexpr size_t ReqMethodCount = HTTP::REQ_PATCH + 1;
+
+HTTP::ReqMethod MethodNameToEnum(std::string_view name) {
+    for (size_t i = 1; i < ReqMethodCount; ++i)
+        if (name == HTTP::ReqName[i])
+            return HTTP::ReqMethod(i);
+    return HTTP::REQ_NONE;
+}
+
+// Returns the position of the next '\n' at or after 'from', or 'len'.
+size_t FindLineFeed(const char* raw, size_t from, size_t len) {
+    return static_cast<size_t>(ScanFor(raw + from, raw + len, '\n') - raw);
+}
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// tchar of RFC 9110, of which a field name consists.
+bool IsTokenChar(char c) {
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+        (c >= '0' && c <= '9'))
+        return true;
+    return c != '\0' && std::strchr("!#$%&'*+-.^_`|~", c) != nullptr;
+}
+
+} // namespace
+
+
+/**
+ * A request line and the header fields end with CRLF, and the head ends
+ * with an empty line. A bare LF is accepted as the end of a line as well.
+ */
+HttpRequestView::ParseStatus HttpRequestView::parse(const char* raw,
+                                                    size_t len) {
+    header_count_ = 0;
+    body_ = std::string_view();
+    content_length_ = 0;
+    has_length_ = false;
+    chunked_ = false;
+
+    // The request line.
+    size_t eol = FindLineFeed(raw, 0, len);
+    if (eol == len)
+        return ParseStatus::INCOMPLETE;
+    size_t end = (eol > 0 && raw[eol - 1] == '\r') ? eol - 1 : eol;
+
+    auto sp1 = ScanFor(raw, raw + end, ' ');
+    if (sp1 == raw + end || sp1 == raw)
+        return ParseStatus::INVALID;
+    size_t uri_begin = static_cast<size_t>(sp1 - raw) + 1;
+    auto sp2 = ScanFor(raw + uri_begin, raw + end, ' ');
+    if (sp2 == raw + end || sp2 == raw + uri_begin)
+        return ParseStatus::INVALID;
+    size_t ver_begin = static_cast<size_t>(sp2 - raw) + 1;
+    if (end - ver_begin < 5 || std::memcmp(raw + ver_begin, "HTTP/", 5) != 0)
+        return ParseStatus::INVALID;
+
+    method_name_ = std::string_view(raw, static_cast<size_t>(sp1 - raw));
+    method_      = MethodNameToEnum(method_name_);
+    uri_         = std::string_view(raw + uri_begin, ver_begin - 1 - uri_begin);
+    version_     = std::string_view(raw + ver_begin + 5, end - ver_begin - 5);
+
+    // The header fields.
+    size_t line = eol + 1;
+    bool   has_encoding = false;
+    for (;;) {
+        eol = FindLineFeed(raw, line, len);
+        if (eol == len)
+            return ParseStatus::INCOMPLETE;
+        end = (eol > line && raw[eol - 1] == '\r') ? eol - 1 : eol;
+        if (end == line) // empty line
+            break;
+
+        auto colon = ScanFor(raw + line, raw + end, ':');
+        if (colon == raw + end || colon == raw + line)
+            return ParseStatus::INVALID;
+        if (header_count_ == MAX_HEADERS)
+            return ParseStatus::INVALID;
+        size_t name_end = static_cast<size_t>(colon - raw);
+        // No whitespace is allowed in or around the name, such as
+        // "Content-Length : 5", which is read differently by others.
+        for (size_t i = line; i < name_end; ++i)
+            if (!IsTokenChar(raw[i]))
+                return ParseStatus::INVALID;
+        size_t value_begin = name_end + 1, value_end = end;
+        while (value_begin < value_end && IsSpace(raw[value_begin]))
+            ++ value_begin;
+        while (value_end > value_begin && IsSpace(raw[value_end - 1]))
+            -- value_end;
+
+        auto& field = headers_[header_count_++];
+        field.name  = std::string_view(raw + line, name_end - line);
+        field.value = std::string_view(raw + value_begin,
+                                       value_end - value_begin);
+
+        if (EqualsIgnoreCase(field.name, "Content-Length")) {
+            // At most 19 digits, which never overflow. A repeated one must
+            // have the same value, or the end of the body is ambiguous.
+            if (field.value.empty() || field.value.size() > 19)
+                return ParseStatus::INVALID;
+            size_t length = 0;
+            for (char c : field.value) {
+                if (c < '0' || c > '9')
+                    return ParseStatus::INVALID;
+                length = length * 10 + static_cast<size_t>(c - '0');
+            }
+            if (has_length_ && length != content_length_)
+                return ParseStatus::INVALID;
+            content_length_ = length;
+            has_length_ = true;
+        }
+        else if (EqualsIgnoreCase(field.name, "Transfer-Encoding")) {
+            has_encoding = true;
+            chunked_ = ChunkedDecoder::IsChunked(field.value);
+        }
+        line = eol + 1;
+    }
+    head_size_ = eol + 1;
+    // Framed by either of them, the ones before this may have chosen the
+    // other, so such a request is rejected (RFC 9112, section 6.1).
+    if (has_encoding && has_length_)
+        return ParseStatus::INVALID;
+
+    size_t remaining = len - head_size_;
+    if (has_encoding)
+        body_ = std::string_view(raw + head_size_, remaining);
+    else if (has_length_)
+        body_ = std::string_view(raw + head_size_,
+            content_length_ < remaining ? content_length_ : remaining);
+    return ParseStatus::OK;
+} // HttpRequestView::parse()
+
+
+std::string_view HttpRequestView::find(std::string_view name) const noexcept {
+    for (size_t i = 0; i < header_count_; ++i)
+        if (EqualsIgnoreCase(headers_[i].name, name))
+            return headers_[i].value;
+    return std::string_view();
+}
+
+
+bool HttpRequestView::has(std::string_view name) const noexcept {
+    for (size_t i = 0; i < header_count_; ++i)
+        if (EqualsIgnoreCase(headers_[i].name, name))
+            return true;
+    return false;
+}
+
+
+HttpRequest HttpRequestView::toRequest() const {
+    HttpRequest ret(HTTP::RequestLine(
+        method_, HTTP::URI(std::string(uri_)), std::string(version_)));
+    for (size_t i = 0; i < header_count_; ++i)
+        ret.addHeader(HTTP::Header(std::string(headers_[i].name),
+                                   std::string(headers_[i].value)));
+    ret.body().assign(body_.begin(), body_.end());
+    return ret;
+}
+
+} // namespace tab
@@ -1,12 +1,68 @@
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+
+#include "EzNet/Basic/platform.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WINDOWS
+#  include <io.h>
+#endif // _WINDOWS
+
 #include "EzNet/HTTP/HTTP_Response.hpp"
 #include "EzNet/HTTP/HTTP_StatusLine.hpp"
 
+#include "EzNet/Utility/General/Scan.hpp"
 #include "EzNet/Utility/General/Transform.hpp"
 
 namespace tab {
 
 namespace HTTP {
 
+namespace {
+
+// The codes of three digits are cached.
+constexpr int MIN_CACHED_CODE = 100;
+constexpr int MAX_CACHED_CODE = 999;
+
+// The lines rendered by this thread, indexed by the code.
+thread_local std::unique_ptr<std::string[]> status_line_cache;
+
+void RenderStatusLine(std::string& out, const ProtocolVersion& version, 
+                      int code, const ResPhrase& phrase) {
+    out.append("HTTP/");
+    out.append(version);
+    out.push_back(' ');
+    out.append(std::to_string(code));
+    out.push_back(' ');
+    out.append(phrase);
+    out.append("\r\n");
+}
+
+} // namespace
+
+void StatusLine::appendTo(std::string& out) const {
+    int code = static_cast<int>(code_);
+    if (code < MIN_CACHED_CODE || code > MAX_CACHED_CODE) {
+        RenderStatusLine(out, version_, code, phrase_);
+        return;
+    }
+    if (!status_line_cache)
+        status_line_cache.reset(
+            new std::string[MAX_CACHED_CODE - MIN_CACHED_CODE + 1]);
+    // "HTTP/" version " " code " " phrase "\r\n"
+    auto& line = status_line_cache[code - MIN_CACHED_CODE];
+    size_t phrase_pos = 5 + version_.size() + 5;
+    if (line.size() != phrase_pos + phrase_.size() + 2 || 
+        line.compare(5, version_.size(), version_) != 0 || 
+        line.compare(phrase_pos, phrase_.size(), phrase_) != 0) {
+        line.clear();
+        RenderStatusLine(line, version_, code, phrase_);
+    }
+    out.append(line);
+}
+
 StatusLine StatusLine::parse(const char* line, size_t len) {
     size_t i = 0;
     size_t limit = len;
@@ -14,10 +70,13 @@ StatusLine StatusLine::parse(const char* line, size_t len) {
     
     // Get the version.
     for (size_t ver_beg = 0; i < limit; ++i) {
+        i = ScanFor(line + i, line + limit, '/', ' ') - line;
+        if (i == limit)
+            break;
         if (line[i] == '/') {
             ver_beg = i + 1;
         }
-        else if (line[i] == ' ') {
+        else {
             ret.version_ = std::move(std::string(line + ver_beg, line + i));
             break;
         }
@@ -29,39 +88,91 @@ StatusLine StatusLine::parse(const char* line, size_t len) {
             break;
     
     // Get the response-code.
-    for (size_t code_beg = i; i < limit; ++i) {
-        if (line[i] == ' ') {
-            ret.code_ 
-                = (RespCode)std::stoi(std::string(line + code_beg, line + i));
-            break;
-        }
-    }
+    size_t code_beg = i;
+    i = ScanFor(line + i, line + limit, ' ') - line;
+    if (i < limit)
+        ret.code_ = (RespCode)std::stoi(std::string(line + code_beg, line + i));
 
     // Skip the spaces and get the response-phrase.
     for (; i < limit; ++i)
         if (line[i] != ' ')
             break;
 
-    size_t offset = 0;
-    for (size_t j = limit - 1; j >= i; --j)
-        if (line[j] == '\r')
-            offset = limit - j;
-    if (i > 0 && limit - offset > i)
-        ret.phrase_ = std::move(std::string(line + i, line + len - offset));
+    size_t phrase_end = ScanFor(line + i, line + limit, '\r') - line;
+    if (i > 0 && phrase_end > i)
+        ret.phrase_ = std::move(std::string(line + i, line + phrase_end));
 
     return ret;
 }
 
 } // namespace HTTP
 
+namespace {
+
+// Get the size and the modification time of the file, 
+// returns false if it is not a regular file.
+bool StatFile(int fd, unsigned long long& size, std::time_t& modified) {
+#ifdef _WINDOWS
+    struct _stat64 st;
+    if (_fstat64(fd, &st) != 0)
+        return false;
+#else
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+        return false;
+#endif
+    size     = static_cast<unsigned long long>(st.st_size);
+    modified = st.st_mtime;
+    return (st.st_mode & S_IFMT) == S_IFREG;
+}
+
+void CloseFile(int fd) {
+#ifdef _WINDOWS
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+} // namespace
+
+HttpFileBody::HttpFileBody(const std::string& path) : 
+    offset_(0), size_(0), owned_(true) {
+#ifdef _WINDOWS
+    fd_ = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+    if (fd_ < 0)
+        throw std::runtime_error(
+            "tab::HttpFileBody::HttpFileBody(): Failed to open " + path + ".");
+    if (!StatFile(fd_, size_, modified_)) {
+        CloseFile(fd_);
+        throw std::runtime_error(
+            "tab::HttpFileBody::HttpFileBody(): " + path + 
+            " is not a regular file.");
+    }
+}
+
+HttpFileBody::HttpFileBody(int fd, unsigned long long offset, 
+                           unsigned long long size, bool owned) :
+    fd_(fd), offset_(offset), size_(size), owned_(owned) {
+    unsigned long long file_size;
+    if (!StatFile(fd_, file_size, modified_))
+        modified_ = 0;
+}
+
+HttpFileBody::~HttpFileBody() {
+    if (owned_)
+        CloseFile(fd_);
+}
+
 HttpResponse HttpResponse::parse(const std::string& raw) {
     size_t i = 0, j;
     size_t limit = raw.size();
     HttpResponse ret;
 
-    for (; i < limit; ++i)
-        if (raw[i] == '\r')
-            break;
+    i = ScanFor(raw.data(), raw.data() + limit, '\r') - raw.data();
 
     if (i > 0)
         ret.status_line_
@@ -71,7 +182,8 @@ HttpResponse HttpResponse::parse(const std::string& raw) {
         return ret;
 
     for (i += 2, j = i; j < limit; ++j) {
-        if (raw[j] == '\r') {
+        j = ScanFor(raw.data() + j, raw.data() + limit, '\r') - raw.data();
+        if (j < limit) {
             std::string&& line = std::string(raw.begin() + i, raw.begin() + j);
             i = j + 2;
             if (!line.empty()) {
@@ -107,13 +219,36 @@ HttpResponse HttpResponse::parse(const std::string& raw) {
     return ret;
 }
 
+void HttpResponse::addField(const char* line, size_t len) {
+    std::string_view field(line, len);
+    auto colon = field.find(':');
+    if (colon != std::string_view::npos && 
+        EqualsIgnoreCase(field.substr(0, colon), "Set-Cookie")) {
+        auto value = field.substr(colon + 1);
+        while (!value.empty() && value.front() == ' ')
+            value.remove_prefix(1);
+        cookies_.add(HTTP::Cookie::parse(std::string(value)));
+    }
+    else {
+        headers_.addField(line, len);
+    }
+}
+
+void HttpResponse::appendHeadTo(std::string& out) const {
+    status_line_.appendTo(out);
+    appendFieldsTo(out);
+}
+
+void HttpResponse::appendFieldsTo(std::string& out) const {
+    headers_.appendTo(out);
+    if (cookies_.size() > 0)
+        out.append(cookies_.getSettingString());
+    out.append("\r\n");
+}
+
 std::string HttpResponse::getStr(void) const {
     std::string ret;
-    ret.append(status_line_.getStr());
-    ret.append(headers_.getStr());
-    if (cookies_.size() > 0)
-        ret.append(cookies_.getSettingString());
-    ret.append("\r\n");
+    appendHeadTo(ret);
     ret.append(body_);
     return ret;
 }
@@ -0,0 +1,249 @@
+#include <string_view>
+
+#include "EzNet/HTTP/HTTP_ResponseParser.hpp"
+#include "EzNet/Utility/General/Scan.hpp"
+#include "EzNet/Utility/General/Transform.hpp"
+
+namespace tab {
+
+namespace {
+
+// Take the line at 'p' without its line break.
+std::string_view NextLine(const char*& p, const char* end) {
+    const char* nl = ScanFor(p, end, '\n');
+    std::string_view line(p, static_cast<size_t>(nl - p));
+    p = nl == end ? end : nl + 1;
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    return line;
+}
+
+// "HTTP/x.y ddd ..."
+bool ValidStatusLine(std::string_view line) {
+    if (line.size() < 12 || line.substr(0, 5) != "HTTP/")
+        return false;
+    auto sp = line.find(' ');
+    if (sp == std::string_view::npos || sp + 4 > line.size())
+        return false;
+    for (size_t i = sp + 1; i < sp + 4; ++i)
+        if (line[i] < '0' || line[i] > '9')
+            return false;
+    return sp + 4 == line.size() || line[sp + 4] == ' ';
+}
+
+} // namespace
+
+
+HttpResponseParser::Status HttpResponseParser::feed(const char* data,
+                                                    size_t len,
+                                                    size_t& consumed) {
+    const char* p = data;
+    const char* end = data + len;
+    for (;;) {
+        Status ret = Status::NEED_MORE;
+        switch (state_) {
+        case State::HEAD:
+            ret = parseHead(p, end);
+            break;
+
+        case State::BODY: {
+            size_t n = remaining_ < static_cast<size_t>(end - p)
+                     ? remaining_ : static_cast<size_t>(end - p);
+            emitBody(p, n);
+            p += n;
+            remaining_ -= n;
+            if (remaining_ == 0)
+                state_ = State::DONE;
+            break;
+        }
+
+        case State::CHUNKED: {
+            size_t n = 0;
+            auto status = chunked_.decode(p, static_cast<size_t>(end - p), n,
+                [this](const char* data, size_t len) { emitBody(data, len); });
+            p += n;
+            if (status == ChunkedDecoder::Status::INVALID)
+                ret = Status::INVALID;
+            else if (status == ChunkedDecoder::Status::TOO_LARGE)
+                ret = Status::TOO_LARGE;
+            else if (status == ChunkedDecoder::Status::COMPLETE)
+                state_ = State::DONE;
+            break;
+        }
+
+        case State::UNTIL_CLOSE:
+            ret = emitBody(p, static_cast<size_t>(end - p));
+            p = end;
+            break;
+
+        case State::DONE:
+            consumed = static_cast<size_t>(p - data);
+            return Status::COMPLETE;
+        }
+
+        if (ret != Status::NEED_MORE) {
+            consumed = static_cast<size_t>(p - data);
+            return ret;
+        }
+        if (p == end && state_ != State::DONE) {
+            consumed = len;
+            return Status::NEED_MORE;
+        }
+    }
+} // HttpResponseParser::feed()
+
+
+HttpResponseParser::Status HttpResponseParser::finish() {
+    switch (state_) {
+    case State::UNTIL_CLOSE:
+        state_ = State::DONE;
+        reusable_ = false;
+        return Status::COMPLETE;
+    case State::DONE:
+        return Status::COMPLETE;
+    case State::HEAD:
+        if (head_.empty())
+            return Status::NEED_MORE;
+        return Status::INVALID;
+    default:
+        return Status::INVALID;
+    }
+}
+
+
+void HttpResponseParser::reset() noexcept {
+    state_     = State::HEAD;
+    response_  = HttpResponse();
+    head_.clear();
+    head_scan_ = 0;
+    body_size_ = 0;
+    remaining_ = 0;
+    no_body_   = false;
+    reusable_  = false;
+    chunked_.reset();
+}
+
+
+HttpResponseParser::Status HttpResponseParser::parseHead(const char*& p,
+                                                         const char* end) {
+    size_t len = static_cast<size_t>(end - p);
+    const char* head = p;
+    size_t n = 0;
+    if (head_.empty()) {
+        // Parse in place if the whole head is here, which is the usual case.
+        n = FindHeadEnd(p, len, head_scan_);
+        if (n == 0) {
+            if (len > limits_.max_head_size)
+                return Status::TOO_LARGE;
+            head_.assign(p, len);
+            p = end;
+            return Status::NEED_MORE;
+        }
+        p += n;
+    }
+    else {
+        size_t old = head_.size();
+        head_.append(p, len);
+        n = FindHeadEnd(head_.data(), head_.size(), head_scan_);
+        if (n == 0) {
+            if (head_.size() > limits_.max_head_size)
+                return Status::TOO_LARGE;
+            p = end;
+            return Status::NEED_MORE;
+        }
+        head = head_.data();
+        p += n - old;
+    }
+    if (n > limits_.max_head_size)
+        return Status::TOO_LARGE;
+
+    const char* q = head;
+    const char* head_end = head + n;
+    auto line = NextLine(q, head_end);
+    if (!ValidStatusLine(line))
+        return Status::INVALID;
+    response_.setStatusLine(HTTP::StatusLine::parse(line.data(), line.size()));
+    while (!(line = NextLine(q, head_end)).empty())
+        response_.addField(line.data(), line.size());
+    head_.clear();
+    head_scan_ = 0;
+
+    int code = static_cast<int>(response_.getCode());
+    if (code >= 100 && code < 200 && code != 101) {
+        // An interim response, the final one follows.
+        response_ = HttpResponse();
+        return Status::NEED_MORE;
+    }
+    return startBody();
+}
+
+
+HttpResponseParser::Status HttpResponseParser::startBody() {
+    auto& headers = response_.getHeaders();
+    auto connection = headers.find(HTTP::CONNECTION);
+    if (response_.getVersion() == "1.0")
+        reusable_ = EqualsIgnoreCase(connection, "keep-alive");
+    else
+        reusable_ = !EqualsIgnoreCase(connection, "close");
+
+    int code = static_cast<int>(response_.getCode());
+    if (no_body_ || code == 101 || code == 204 || code == 304) {
+        // The connection belongs to another protocol after 101.
+        if (code == 101)
+            reusable_ = false;
+        state_ = State::DONE;
+        return Status::NEED_MORE;
+    }
+
+    auto encoding = headers.find(HTTP::TRANSFER_ENCODING);
+    if (!encoding.empty()) {
+        if (ChunkedDecoder::IsChunked(encoding)) {
+            chunked_.setMaxBodySize(limits_.max_body_size);
+            chunked_.setMaxTrailerSize(limits_.max_head_size);
+            chunked_.setTrailerHandler([this](std::string_view line) {
+                response_.addField(line.data(), line.size());
+            });
+            state_ = State::CHUNKED;
+        }
+        else {
+            state_ = State::UNTIL_CLOSE;
+            reusable_ = false;
+        }
+        return Status::NEED_MORE;
+    }
+
+    auto length = headers.find(HTTP::CONTENT_LENGTH);
+    if (length.empty()) {
+        state_ = State::UNTIL_CLOSE;
+        reusable_ = false;
+        return Status::NEED_MORE;
+    }
+    size_t size = 0;
+    for (char c : length) {
+        if (c < '0' || c > '9' || size > (~size_t(0) >> 4))
+            return Status::INVALID;
+        size = size * 10 + static_cast<size_t>(c - '0');
+    }
+    if (limits_.max_body_size != 0 && size > limits_.max_body_size)
+        return Status::TOO_LARGE;
+    remaining_ = size;
+    state_ = size > 0 ? State::BODY : State::DONE;
+    return Status::NEED_MORE;
+}
+
+
+HttpResponseParser::Status HttpResponseParser::emitBody(const char* p,
+                                                        size_t n) {
+    if (n == 0)
+        return Status::NEED_MORE;
+    body_size_ += n;
+    if (limits_.max_body_size != 0 && body_size_ > limits_.max_body_size)
+        return Status::TOO_LARGE;
+    if (sink_)
+        sink_(p, n);
+    else
+        response_.getBody().append(p, n);
+    return Status::NEED_MORE;
+}
+
+} // namespace tab
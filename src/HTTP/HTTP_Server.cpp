@@ -1,8 +1,212 @@
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "EzNet/HTTP/HTTP_Date.hpp"
 #include "EzNet/HTTP/HTTP_Server.hpp"
 #include "EzNet/Utility/General/Transform.hpp"
-#include <iostream>
+
 namespace tab {
 
+namespace {
+
+/**
+ * The state of a connection, kept in 'userData()'.
+ * 
+ * The responses of the requests received by one read are sent by one
+ * gathering write: the heads (with the small bodies) are rendered into 
+ * 'head', and the large bodies and the files are referred to by the 
+ * segments without being copied. They are kept until the write finishes.
+ */
+struct HttpConnection {
+    HttpConnection(const HttpRequestParser::Limits& limits) : 
+        parser(limits) { }
+
+    struct Body {
+        // Where it is put in 'head'.
+        size_t      cut;
+        std::string data;
+        // Sent instead of 'data' if it is not null.
+        std::shared_ptr<const HttpFileBody> file;
+        unsigned long long offset = 0;
+        unsigned long long size   = 0;
+    };
+
+    void clearOutput() {
+        head.clear();
+        bodies.clear();
+        segments.clear();
+    }
+
+    // 'head' is cut where the bodies are put, so the segments are made
+    // after all the responses are rendered, when 'head' no longer moves.
+    void makeSegments() {
+        size_t begin = 0;
+        for (auto& body : bodies) {
+            if (body.cut > begin)
+                segments.push_back({head.data() + begin, body.cut - begin});
+            if (body.file)
+                segments.push_back({nullptr, static_cast<size_t>(body.size),
+                                    body.file->getFile(), body.offset});
+            else
+                segments.push_back({body.data.data(), body.data.size()});
+            begin = body.cut;
+        }
+        if (head.size() > begin)
+            segments.push_back({head.data() + begin, head.size() - begin});
+    }
+
+    HttpRequestParser          parser;
+    std::string                head;
+    std::vector<Body>          bodies;
+    std::vector<OutputSegment> segments;
+};
+
+// At most this many connection states of the closed connections are 
+// kept in each thread for the new ones.
+constexpr size_t CONNECTION_POOL_LIMIT = 256;
+
+// Copying a body smaller than this into 'HttpConnection::head' is cheaper
+// than another segment.
+constexpr size_t INLINE_BODY_LIMIT = 1024;
+
+thread_local std::vector<std::unique_ptr<HttpConnection>> connection_pool;
+
+HttpConnection* AcquireConnection(const HttpRequestParser::Limits& limits) {
+    if (connection_pool.empty())
+        return new HttpConnection(limits);
+    auto ret = connection_pool.back().release();
+    connection_pool.pop_back();
+    ret->parser.limits() = limits;
+    return ret;
+}
+
+void ReleaseConnection(HttpConnection* conn) {
+    if (connection_pool.size() >= CONNECTION_POOL_LIMIT) {
+        delete conn;
+        return;
+    }
+    conn->parser.reset();
+    conn->clearOutput();
+    connection_pool.emplace_back(conn);
+}
+
+void AppendError(std::string& out, const char* status_line) {
+    out += status_line;
+    out += "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+}
+
+// Parse the digits of 'str' to 'value', returns false if it is empty, 
+// or anything else is in it, or it overflows.
+bool ParseUnsigned(std::string_view str, unsigned long long& value) {
+    if (str.empty() || str.size() > 19)
+        return false;
+    value = 0;
+    for (char c : str) {
+        if (c < '0' || c > '9')
+            return false;
+        value = value * 10 + static_cast<unsigned long long>(c - '0');
+    }
+    return true;
+}
+
+/**
+ * Parse a "Range" of a single range of bytes ("first-last", "first-" or 
+ * "-suffix") of a body of 'size' bytes, into the first and the last byte.
+ * Returns 1 if it is satisfiable, 0 if it is not, and -1 if it should be 
+ * ignored: it is invalid, or it has more than one range.
+ */
+int ParseRange(std::string_view range, unsigned long long size, 
+               unsigned long long& first, unsigned long long& last) {
+    if (range.size() < 6 || !EqualsIgnoreCase(range.substr(0, 6), "bytes="))
+        return -1;
+    range.remove_prefix(6);
+    while (!range.empty() && range.front() == ' ')
+        range.remove_prefix(1);
+    while (!range.empty() && range.back() == ' ')
+        range.remove_suffix(1);
+    auto dash = range.find('-');
+    if (dash == std::string_view::npos || 
+        range.find(',') != std::string_view::npos)
+        return -1;
+    auto first_str = range.substr(0, dash);
+    auto last_str  = range.substr(dash + 1);
+    if (first_str.empty()) { // the last 'suffix' bytes
+        unsigned long long suffix;
+        if (!ParseUnsigned(last_str, suffix))
+            return -1;
+        if (suffix == 0 || size == 0)
+            return 0;
+        first = suffix < size ? size - suffix : 0;
+        last  = size - 1;
+        return 1;
+    }
+    if (!ParseUnsigned(first_str, first))
+        return -1;
+    last = size - 1;
+    if (!last_str.empty()) {
+        unsigned long long end;
+        if (!ParseUnsigned(last_str, end) || end < first)
+            return -1;
+        if (end < last)
+            last = end;
+    }
+    return first < size ? 1 : 0;
+}
+
+/**
+ * Fill the headers of a response whose body is a file, and choose the 
+ * part of it to send ('offset' and 'size'), which is the whole file, or 
+ * the single range requested by "Range" with "206 Partial Content". If 
+ * the range is not satisfiable, it is "416 Range Not Satisfiable" without
+ * a body. A range is only served for "GET", and "If-Range" must match the
+ * "Last-Modified" of the file.
+ */
+void PrepareFileBody(const HttpRequestView& request, HttpResponse& response,
+                     unsigned long long& offset, unsigned long long& size) {
+    auto& file    = *response.getFileBody();
+    auto& headers = response.getHeaders();
+    offset = file.getOffset();
+    size   = file.getSize();
+    headers[HTTP::ACCEPT_RANGES] = "bytes";
+    std::string modified;
+    if (file.getModifiedTime() != 0) {
+        modified = HTTP::FormatDate(file.getModifiedTime());
+        headers[HTTP::LAST_MODIFIED] = modified;
+    }
+
+    auto range = request.find(HTTP::RANGE);
+    if (range.empty() || request.getMethod() != HTTP::REQ_GET || 
+        response.getCode() != HTTP::RespCode::OK)
+        return;
+    auto if_range = request.find(HTTP::IF_RANGE);
+    if (!if_range.empty() && (modified.empty() || if_range != modified))
+        return;
+    unsigned long long first = 0, last = 0;
+    int satisfiable = ParseRange(range, size, first, last);
+    if (satisfiable < 0)
+        return;
+    auto& status = response.getStatusLine();
+    if (satisfiable == 0) {
+        status.setCode(HTTP::RespCode::REQUESTED_RANGE_NOT_SATISFIABLE);
+        status.setPhrase("Range Not Satisfiable");
+        headers[HTTP::CONTENT_RANGE] = "bytes */" + std::to_string(size);
+        size = 0;
+        return;
+    }
+    status.setCode(HTTP::RespCode::PARTIAL_CONTENT);
+    status.setPhrase("Partial Content");
+    headers[HTTP::CONTENT_RANGE] = 
+        "bytes " + std::to_string(first) + "-" + std::to_string(last) + 
+        "/" + std::to_string(size);
+    offset += first;
+    size    = last - first + 1;
+}
+
+} // namespace
+
 HttpServer::HttpServer(const TcpConfig& c) : TcpServer(c) {
     loadEventListeners();
 }
@@ -12,66 +216,141 @@ HttpServer::HttpServer() : TcpServer() {
 }
 
 void HttpServer::loadEventListeners() {
-    auto matcher_ptr = &event_matcher_;
+    auto matcher_ptr = &http_matcher_;
+    auto config_ptr = &config_http_;
+    auto static_ptr = &static_headers_;
 
-    registerEvent<DataReceivedEvent>([matcher_ptr](DataReceivedEvent& e) {
-        if (e.getContentSize() == e.getBufferSize()) {
-            // TODO: e.requireAdditionalBuffer()
-        }
-        
-        auto&& req = HttpRequest::parse(e.getBuffer(), e.getBufferSize());
-
-        bool keep_alive = false;
-        try {
-            auto&& str = req.headers().find(HTTP::CONNECTION);
-            if (!str.empty()) {
-                if (UppercaseToLower(str) == "keep-alive") {
-                    keep_alive = true;
-                    e.flag() = TcpServerEvent::OP_READ;
-                }
-                else if (str == "close") {
-                    e.flag() = TcpServerEvent::OP_CLOSE;
-                }
-                else
-                    throw (char)0;
+    registerEvent<DataReceivedEvent>(
+            [matcher_ptr, config_ptr, static_ptr](DataReceivedEvent& e) {
+        // Each connection keeps a parser, so the request can be 
+        // received by several reads.
+        if (e.userData() == nullptr)
+            e.userData() = AcquireConnection(config_ptr->limits);
+        auto conn = static_cast<HttpConnection*>(e.userData());
+        auto parser = &conn->parser;
+        auto& output = conn->head;
+
+        // Pipelined requests are handled in order, 
+        // until the data run out or the connection is to be closed.
+        const char* data = e.getBuffer();
+        size_t left = e.getContentSize();
+        bool keep_alive = true;
+        conn->clearOutput();
+        while (keep_alive) {
+            size_t consumed = 0;
+            auto status = parser->feed(data, left, consumed);
+            data += consumed;
+            left -= consumed;
+            if (status == HttpRequestParser::Status::NEED_MORE)
+                break;
+            if (status == HttpRequestParser::Status::INVALID) {
+                AppendError(output, "HTTP/1.1 400 Bad Request");
+                keep_alive = false;
+                break;
             }
+            if (status == HttpRequestParser::Status::TOO_LARGE) {
+                AppendError(output, "HTTP/1.1 413 Payload Too Large");
+                keep_alive = false;
+                break;
+            }
+            auto& view = parser->request();
+
+            // "Connection" overrides the default of the protocol version.
+            auto connection = view.find(HTTP::CONNECTION);
+            if (EqualsIgnoreCase(connection, "keep-alive"))
+                keep_alive = true;
+            else if (EqualsIgnoreCase(connection, "close"))
+                keep_alive = false;
             else
-                throw (char)0;
-        }
-        catch (char) { // header "Connection" is not found or the value is invalid
-            if (req.getRequestLine().getVersion() == "1.0") {
-                e.flag() = TcpServerEvent::OP_CLOSE;
+                keep_alive = view.getVersion() != "1.0";
+
+            HttpRequestReceivedEvent event(view);
+            matcher_ptr->call(event);
+
+            if (event.close_)
+                keep_alive = false;
+            auto& response = event.response_;
+            auto& body = response.getBody();
+            unsigned long long offset = 0, length = body.size();
+            if (response.getFileBody())
+                PrepareFileBody(view, response, offset, length);
+            // The head of a response to HEAD describes the body which is
+            // not sent, and 1xx and 204 have no length at all.
+            int code = static_cast<int>(response.getCode());
+            bool no_length = code < 200 || code == 204;
+            bool no_body = no_length || code == 304 ||
+                           view.getMethod() == HTTP::REQ_HEAD;
+            if (!no_length)
+                response
+                    .getHeaders()
+                    .addHeader(HTTP::CONTENT_LENGTH, std::to_string(length));
+            // The status line is cached, and the fields which never 
+            // change are copied as they are.
+            response.getStatusLine().appendTo(output);
+            if (config_ptr->date_header && 
+                !response.getHeaders().contains(HTTP::DATE)) {
+                output.append("Date: ", 6);
+                output.append(HTTP::CurrentDate(), HTTP::DATE_LENGTH);
+                output.append("\r\n", 2);
+            }
+            for (size_t i = 0; i < static_ptr->size(); ++i) {
+                auto& block = (*static_ptr)[i];
+                if (block.always || (event.static_headers_ >> i & 1))
+                    output.append(block.fields);
+            }
+            response.appendFieldsTo(output);
+            if (no_body) {
+                // Nothing follows the head.
+            }
+            else if (response.getFileBody()) {
+                if (length > 0)
+                    conn->bodies.push_back({output.size(), std::string(), 
+                        response.getFileBody(), offset, length});
+            }
+            else if (body.size() < INLINE_BODY_LIMIT) {
+                output += body;
             }
             else {
-                keep_alive = true;
-                e.flag() = TcpServerEvent::OP_READ;
+                conn->bodies.push_back(
+                    {output.size(), std::move(body), nullptr, 0, 0});
             }
+            parser->reset();
+            if (left == 0)
+                break;
         }
 
-        HttpRequestReceivedEvent event(std::move(req));
-        matcher_ptr->call(event);
-        
-        if (event.close_ || !keep_alive) 
-            e.flag() = TcpServerEvent::OP_CLOSE;
-        event.response_
-            .getHeaders()
-            .addHeader(HTTP::CONTENT_LENGTH, 
-                std::to_string(event.response_.getBody().size()).c_str());
-        auto&& response = event.response_.getStr();
-        memcpy(e.getBuffer(), response.c_str(), response.size());
-        e.setContentSize(static_cast<unsigned long>(response.size()));
-        e.setNextOperation(TcpServerEvent::OP_WRITE);
+        if (output.empty() && conn->bodies.empty()) { 
+            // waiting for the rest of a request
+            e.setNextOperation(TcpServerEvent::OP_READ);
+            return;
+        }
+        e.flag() = keep_alive ? TcpServerEvent::OP_READ 
+                              : TcpServerEvent::OP_CLOSE;
+        conn->makeSegments();
+        e.setOutputSegments(conn->segments.data(), conn->segments.size());
     });  // DataReceivedEvent
 
+    registerEvent<ConnectionClosedEvent>([](ConnectionClosedEvent& e) {
+        if (e.userData() != nullptr) {
+            ReleaseConnection(static_cast<HttpConnection*>(e.userData()));
+            e.userData() = nullptr;
+        }
+    });
+
     // This handler will be replaced if the user registers later.
-    registerEvent<HttpRequestReceivedEvent>([](HttpRequestReceivedEvent){});
+    registerEvent<HttpRequestReceivedEvent>([](HttpRequestReceivedEvent&){});
 
     registerEvent<DataSentEvent>([](DataSentEvent& e) {
         if (e.flag() == TcpServerEvent::OP_CLOSE) {
             e.setNextOperation(TcpServerEvent::OP_CLOSE);
         }
         else {
-            // TODO: Determine which buffer to use
+            // The bodies sent are freed, the buffers of the heads are kept.
+            if (e.userData() != nullptr)
+                static_cast<HttpConnection*>(e.userData())->clearOutput();
+            // On Windows the response is gathered in the extended buffer,
+            // while the requests are always received by the default one.
+            e.setActiveBuffer(TcpServerEventBase::DEFAULT);
             e.setNextOperation(TcpServerEvent::OP_READ);
         }
     });
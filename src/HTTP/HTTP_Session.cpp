@@ -7,6 +7,7 @@
 
 #include "EzNet/Socket/StreamSocket.hpp"
 #include "EzNet/HTTP/HTTP_Session.hpp"
+#include "EzNet/HTTP/HTTP_ResponseParser.hpp"
 #include "EzNet/Utility/General/Transform.hpp"
 
 #include "Receiver.hpp"
@@ -30,25 +31,29 @@ HttpSessionClient::HttpSessionClient(const HttpSessionClient& hs) :
                 new HttpResponse(*hs.response_)),
     target_(hs.target_),
     writer_(hs.writer_),
-    get_socket_(hs.get_socket_) { }
+    get_socket_(hs.get_socket_),
+    pool_(hs.pool_) { }
     
 
 HttpSessionClient::HttpSessionClient(HttpSessionClient&& hs) :
     HttpSession(std::move(hs.request_), std::move(hs.response_)),
     target_(std::move(hs.target_)),
     writer_(std::move(hs.writer_)),
-    get_socket_(std::move(hs.get_socket_)) {
+    get_socket_(std::move(hs.get_socket_)),
+    pool_(std::move(hs.pool_)) {
         std::swap(socket_, hs.socket_);
         std::swap(alive_, hs.alive_);
     }
 
 
 HttpSessionClient& HttpSessionClient::operator=(HttpSessionClient&& hs) {
+    releaseSocket();
     request_ = std::move(hs.request_);
     response_ = std::move(hs.response_);
     get_socket_ = std::move(hs.get_socket_);
     target_ = std::move(hs.target_);
     writer_ = std::move(hs.writer_);
+    pool_ = std::move(hs.pool_);
     std::swap(socket_, hs.socket_);
     std::swap(alive_, hs.alive_);
     return *this;
@@ -56,11 +61,13 @@ HttpSessionClient& HttpSessionClient::operator=(HttpSessionClient&& hs) {
 
 
 HttpSessionClient& HttpSessionClient::operator=(const HttpSessionClient& hs) {
+    releaseSocket();
     *request_ = *hs.request_;
     *response_ = *hs.response_;
     get_socket_ = hs.get_socket_;
     target_ = hs.target_;
     writer_ = hs.writer_;
+    pool_ = hs.pool_;
     return *this;
 }
 
@@ -72,14 +79,10 @@ HttpSessionClient& HttpSessionClient::setURL(const URL& url) {
             "tab::HttpSessionClient::setURL(): "
             "The protocol is not HTTP or HTTPS.");
     }
+    releaseSocket();
     request_->setURI(url.getPath());
     request_->addHeader(HTTP::HOST, url.getHostName());
     target_ = url;
-    if (alive_) {
-        socket_->shutdown();
-        socket_->close();
-        alive_ = false;
-    }
     return *this;
 }
 
@@ -94,65 +97,109 @@ HttpSessionClient& HttpSessionClient::setKeepAlive(bool opt) {
 }
 
 
-void HttpSessionClient::performSingleRequest(
-    char* recv_buffer, const size_t recv_buffer_size) {
-    if (!alive_) {
-        socket_ = get_socket_(
-            target_.getHost().getAddr().getAF(), 
-            target_.getProtocol() == URL::Protocol::HTTPS ? (char)1 : (char)0);
-        try{
-            if (!socket_->connect(
-                target_.getHost().getAddr().setProtocol(IPPROTO_TCP))) {
-                throw std::runtime_error(
-                    "tab::HttpSessionClient::request(): "
-                    "Can not connect to the destination.");
-            }
-        }
-        catch (const std::exception& e) {
+bool HttpSessionClient::borrowSocket() {
+    if (!pool_)
+        return false;
+    socket_ = pool_->acquire(target_);
+    alive_ = static_cast<bool>(socket_);
+    return alive_;
+}
+
+
+void HttpSessionClient::connectSocket() {
+    socket_ = get_socket_(
+        target_.getHost().getAddr().getAF(), 
+        target_.getProtocol() == URL::Protocol::HTTPS ? (char)1 : (char)0,
+        target_.getHostName());
+    try{
+        if (!socket_->connect(
+            target_.getHost().getAddr().setProtocol(IPPROTO_TCP))) {
             throw std::runtime_error(
-                std::string(
-                    "tab::HttpSessionClient::request(): "
-                    "Error(s) occurred while connecting "
-                    "to the destination.\r\n  std::exception::what(): "
-                ) + e.what()
-            );
+                "tab::HttpSessionClient::request(): "
+                "Can not connect to the destination.");
         }
-        alive_ = true;
     }
+    catch (const std::exception& e) {
+        close();
+        throw std::runtime_error(
+            std::string(
+                "tab::HttpSessionClient::request(): "
+                "Error(s) occurred while connecting "
+                "to the destination.\r\n  std::exception::what(): "
+            ) + e.what()
+        );
+    }
+    alive_ = true;
+}
+
+
+void HttpSessionClient::releaseSocket() {
+    if (alive_ && pool_)
+        pool_->release(target_, std::move(socket_));
+    close();
+}
+
+
+void HttpSessionClient::performSingleRequest(
+    char* recv_buffer, const size_t recv_buffer_size) {
+    // A connection used before may have been closed by the server
+    // while it was idle. If so, the request is sent once more on a
+    // new connection.
+    bool reused = alive_ || borrowSocket();
+    if (!alive_)
+        connectSocket();
 
     auto request_buffer = request_->getBuffer();
+    Receiver receiver(recv_buffer, recv_buffer_size, writer_);
 
-    size_t bytes_sent = 0;
-    try {
-        bytes_sent = socket_->send(
-            request_buffer.begin(), static_cast<int>(request_buffer.size()));
-        if(bytes_sent != request_buffer.size())
-            throw std::runtime_error(
-                std::string("Bytes sent is not equal to the request data size (sent=") +
-                std::to_string(bytes_sent) + ", data=" +
-                std::to_string(request_buffer.size()));
-    } catch (const std::exception& e) {
-        alive_ = false;
-        throw std::runtime_error (
-                std::string(
-                    "tab::HttpSessionClient::request(): Error(s) occurred "
-                    "while sending request to the destination.\r\n  "
-                    "std::exception::what(): "
-                ) + e.what()
-            );
+    for (;;) {
+        try {
+            auto bytes_sent = socket_->send(
+                request_buffer.begin(), static_cast<int>(request_buffer.size()));
+            if (bytes_sent < 0 || 
+                static_cast<size_t>(bytes_sent) != request_buffer.size())
+                throw std::runtime_error(
+                    std::string("Bytes sent is not equal to the request data size (sent=") +
+                    std::to_string(bytes_sent) + ", data=" +
+                    std::to_string(request_buffer.size()));
+        } catch (const std::exception& e) {
+            close();
+            if (reused) {
+                reused = false;
+                connectSocket();
+                continue;
+            }
+            throw std::runtime_error (
+                    std::string(
+                        "tab::HttpSessionClient::request(): Error(s) occurred "
+                        "while sending request to the destination.\r\n  "
+                        "std::exception::what(): "
+                    ) + e.what()
+                );
+        }
+
+        try {
+            receiver.receive(socket_.get());
+        } catch (...) {
+            close();
+            if (!reused || receiver.head_received_)
+                throw;
+        }
+        if (receiver.head_received_ || !reused)
+            break;
+        close();
+        reused = false;
+        connectSocket();
     }
     request_buffer.release();
-        
-    Receiver receiver(recv_buffer, recv_buffer_size, writer_);
-    receiver.receive(socket_.get());
+
     *response_ = std::move(receiver.resp_);
-        
-    if (!options_.keep_alive || 
+
+    // Only a connection whose response has been read to the end
+    // can be used again.
+    if (!options_.keep_alive || !receiver.complete_ ||
         response_->getHeaders().find(HTTP::CONNECTION) == "close") {
-        alive_ = false;
-        socket_.reset(); // equals to the code below
-        // socket_->shutdown();
-        // socket_->close();
+        close();
     }
 }
 
@@ -182,9 +229,8 @@ void HttpSessionClient::performSerialRequest() {
                 request_->setURI(sLocation);
             }
             else {
+                releaseSocket();
                 target_ = location;
-                if (alive_) 
-                    alive_ = false;
                 request_->addHeader(HTTP::HOST, location.getHostName());
             }
 
@@ -216,4 +262,109 @@ HttpResponse& HttpSessionClient::request() {
 } // HttpSessionClient::request()
 
 
+namespace {
+
+bool SendAll(Socket* s, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        int n = s->send(data.data() + sent, 
+                        static_cast<int>(data.size() - sent));
+        if (n <= 0)
+            return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+
+std::vector<HttpResponse> HttpSessionClient::requestBatch(
+    const std::vector<HttpRequest>& requests, size_t max_in_flight) {
+    const size_t n = requests.size();
+    if (max_in_flight == 0)
+        max_in_flight = 1;
+    std::vector<std::string> wire;
+    wire.reserve(n);
+    for (auto& r : requests) {
+        HttpRequest copy(r);
+        if (copy.headers().find(HTTP::HOST).empty())
+            copy.addHeader(HTTP::HOST, target_.getHostName());
+        wire.push_back(copy.getString());
+    }
+
+    std::vector<HttpResponse> ret;
+    ret.reserve(n);
+    const size_t recv_buffer_size = 0x4000;
+    std::unique_ptr<char[]> recv_buffer(new char[recv_buffer_size]);
+    HttpResponseParser parser;
+
+    while (ret.size() < n) {
+        // The answered ones are not sent again on a new connection.
+        bool reused = alive_ || borrowSocket();
+        if (!alive_)
+            connectSocket();
+        size_t answered = ret.size();
+        size_t next = ret.size();
+        bool usable = true;
+        parser.reset();
+        parser.setNoBody(requests[next].getMethod() == HTTP::REQ_HEAD);
+
+        while (usable && ret.size() < n) {
+            // Keep the pipeline full.
+            std::string out;
+            while (next < n && next - ret.size() < max_in_flight)
+                out.append(wire[next++]);
+            if (!out.empty() && !SendAll(socket_.get(), out)) {
+                usable = false;
+                break;
+            }
+
+            int received = socket_->recv(
+                recv_buffer.get(), static_cast<int>(recv_buffer_size));
+            if (received <= 0) {
+                if (parser.finish() == HttpResponseParser::Status::COMPLETE)
+                    ret.push_back(std::move(parser.response()));
+                usable = false;
+                break;
+            }
+
+            // A piece may hold the end of a response and the beginning
+            // of the next ones.
+            const char* p = recv_buffer.get();
+            size_t left = static_cast<size_t>(received);
+            while (left > 0 && usable && ret.size() < n) {
+                size_t consumed = 0;
+                auto status = parser.feed(p, left, consumed);
+                p += consumed;
+                left -= consumed;
+                if (status == HttpResponseParser::Status::NEED_MORE)
+                    break;
+                if (status != HttpResponseParser::Status::COMPLETE) {
+                    close();
+                    throw std::runtime_error(
+                        "tab::HttpSessionClient::requestBatch(): "
+                        "The response is invalid or too large.");
+                }
+                usable = parser.reusable();
+                ret.push_back(std::move(parser.response()));
+                parser.reset();
+                if (ret.size() < n)
+                    parser.setNoBody(
+                        requests[ret.size()].getMethod() == HTTP::REQ_HEAD);
+            }
+        }
+
+        if (!usable || !options_.keep_alive)
+            close();
+        if (ret.size() == answered && !reused) {
+            throw std::runtime_error(
+                "tab::HttpSessionClient::requestBatch(): "
+                "The connection is closed without any response.");
+        }
+    }
+    return ret;
+} // HttpSessionClient::requestBatch()
+
+
 } // namespace tab
\ No newline at end of file
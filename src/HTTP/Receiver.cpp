@@ -1,11 +1,17 @@
 #include <algorithm>
+#include <cstring>
 #include <exception>
 #include <functional>
+#include <string>
+#include <string_view>
 #include <utility>
 
 #include "Receiver.hpp"
 
+#include "EzNet/HTTP/HTTP_ChunkedDecoder.hpp"
+
 #include "EzNet/Utility/Memory/Memory.hpp"
+#include "EzNet/Utility/General/Scan.hpp"
 #include "EzNet/Utility/General/Transform.hpp"
 
 namespace tab {
@@ -57,15 +63,75 @@ public:
         }, len);
     }
 
-    char read() {
-        if (cur_ >= recv_) {
-            recv_ = sock_->recv(buf_, static_cast<int>(buf_len_));
-            if (recv_ <= 0)
-                throw recv_;
-            cur_ = 0;
+    /**
+     * Get the next line without its line break, CRLF or a bare LF. 
+     * The line refers to the buffer (or to the spilled part, if it is 
+     * longer than the buffer), valid until the next reading.
+     * 
+     * Returns false if the connection is closed before the line ends.
+     */
+    bool readLine(std::string_view& line) {
+        spill_.clear();
+        size_t scanned = cur_;
+        for (;;) {
+            auto nl = ScanFor(buf_ + scanned, buf_ + recv_, '\n');
+            if (nl != buf_ + recv_) {
+                const char* begin = buf_ + cur_;
+                size_t len = static_cast<size_t>(nl - begin);
+                cur_ = static_cast<size_t>(nl - buf_) + 1;
+                if (!spill_.empty()) {
+                    spill_.append(begin, len);
+                    begin = spill_.data();
+                    len = spill_.size();
+                }
+                if (len > 0 && begin[len - 1] == '\r')
+                    -- len;
+                line = std::string_view(begin, len);
+                return true;
+            }
+            // Keep the incomplete line at the beginning of the buffer, 
+            // and receive the rest after it.
+            if (cur_ > 0) {
+                std::memmove(buf_, buf_ + cur_, recv_ - cur_);
+                recv_ -= cur_;
+                cur_ = 0;
+            }
+            else if (recv_ == buf_len_) {
+                spill_.append(buf_, recv_);
+                recv_ = 0;
+            }
+            scanned = recv_;
+            int n = sock_->recv(buf_ + recv_, 
+                                static_cast<int>(buf_len_ - recv_));
+            if (n <= 0)
+                return false;
+            recv_ += static_cast<size_t>(n);
         }
-        ++ cur_;
-        return buf_[cur_ - 1];
+    }
+
+    /**
+     * Receive a block if all the received data have been read.
+     * Returns false if the connection is closed.
+     */
+    bool fill() {
+        if (cur_ < recv_)
+            return true;
+        int n = sock_->recv(buf_, static_cast<int>(buf_len_));
+        if (n <= 0)
+            return false;
+        recv_ = static_cast<size_t>(n);
+        cur_ = 0;
+        return true;
+    }
+
+    // The data received but not read yet, 
+    // there are 'waiting_for_reading()' bytes.
+    const char* current() {
+        return buf_ + cur_;
+    }
+
+    void skip(size_t len) {
+        cur_ += len;
     }
 
     size_t waiting_for_reading() {
@@ -82,125 +148,68 @@ private:
     size_t buf_len_;
     size_t recv_;
     size_t cur_;
+    // The beginning of a line longer than the buffer.
+    std::string spill_;
 };
 
 // TODO: Complete this method 
 Receiver& Receiver::receive(Socket* s) {
-    Buffer temp(4096);
     ReceiveQueue receive_queue(s, buffer_, buffer_length_);
 
-    bool has_cr = false;
-    for (size_t n_line = 0;;) {
-        char cur = 0;
-        
-        try {
-            cur = receive_queue.read();
-        }
-        catch (int) {
+    // The head is parsed line by line in the received blocks.
+    std::string_view line;
+    if (!receive_queue.readLine(line))
+        return *this;
+    resp_.status_line_ = HTTP::StatusLine::parse(line.data(), line.size());
+    for (;;) {
+        if (!receive_queue.readLine(line))
             return *this;
-        }
-
-        if (cur == '\r') {
-            has_cr = true;
-        }
-        else if (cur == '\n' && has_cr) {
-            has_cr = false;
-            if (temp.size() == 0) {
-                break;
-            }
-            if (n_line == 0)
-                resp_.status_line_ = std::move(
-                    HTTP::StatusLine::parse(temp.begin(), temp.size()));
-            else {
-                auto&& header = HTTP::Header::parse(temp.begin(), temp.size());
-                if (header.type() == HTTP::Header::Type::Common) {
-                    auto& converted_header = header.to<HTTP::CommonHeader>();
-                    if (converted_header.getKey() == HTTP::SET_COOKIE)
-                        resp_.getCookies()
-                             .add(HTTP::Cookie::parse(
-                                converted_header.getValue()));
-                    else
-                        resp_.addHeader(std::move(header));
-                }
-                else {
-                    std::string key_str(std::move(header.getKeyString()));
-                    if (UppercaseToLower(key_str) == "set-cookie")
-                        resp_.getCookies()
-                             .add(HTTP::Cookie::parse(header.getValue()));
-                    else
-                        resp_.addHeader(std::move(header));
-                }
-            }
-            ++n_line;
-            temp.clear();
-        }
-        else {
-            temp.append(cur);
-        }
+        if (line.empty())
+            break;
+        resp_.addField(line.data(), line.size());
     }
+    head_received_ = true;
 
     std::string transfer_encoding(
         std::move(resp_.getHeaders().find(HTTP::TRANSFER_ENCODING)));
 
-    if (transfer_encoding.empty()) {
-        auto&& content_length = resp_.headers_.find(HTTP::CONTENT_LENGTH);
-        if (!content_length.empty()) {
-            receive_queue.read(write_, std::stoull(content_length));
-        }
-        else {
-            write_(buffer_ + receive_queue.begin(), 
-                   receive_queue.waiting_for_reading());
-            for (int n;;) {
-                n = s->recv(buffer_, static_cast<int>(buffer_length_));
-                if (n <= 0)
-                    break;
-                write_(buffer_, n);
+    auto&& content_length = resp_.headers_.find(HTTP::CONTENT_LENGTH);
+
+    if (ChunkedDecoder::IsChunked(transfer_encoding)) {
+        // The payload goes to the writer straight from the buffer.
+        ChunkedDecoder decoder;
+        decoder.setTrailerHandler([this](std::string_view line) {
+            resp_.addField(line.data(), line.size());
+        });
+        ChunkedDecoder::Sink sink = [this](const char* data, size_t len) {
+            write_(const_cast<char*>(data), len);
+        };
+        while (receive_queue.fill()) {
+            size_t consumed = 0;
+            auto status = decoder.decode(receive_queue.current(),
+                                         receive_queue.waiting_for_reading(),
+                                         consumed, sink);
+            receive_queue.skip(consumed);
+            if (status != ChunkedDecoder::Status::NEED_MORE) {
+                complete_ = status == ChunkedDecoder::Status::COMPLETE;
+                break;
             }
         }
     }
-    else if (transfer_encoding.find("chunked") != std::string::npos) {
-        temp.release();
-        std::string chunk_len_str;
-        size_t chunk_len;
-
-        char recv_char = receive_queue.read();
-        for (;;) {
-            for (; ; recv_char = receive_queue.read()) {
-                if (recv_char != '\r') {
-                    if (recv_char != ' ') {
-                        chunk_len_str.push_back(recv_char);
-                    }
-                    else {
-                        for (; 
-                        recv_char == ' '; 
-                        recv_char = receive_queue.read());
-                        break;
-                    }
-                }
-                else
-                    break;
-            }
-
-            if (recv_char == '\r')
-                recv_char = receive_queue.read();
-            if (recv_char == '\n')
-                recv_char = receive_queue.read();
-
-            chunk_len = HexStrToULL(chunk_len_str);
-            chunk_len_str.clear();
-            if (chunk_len == 0) {
-                for (; recv_char == '\r'; recv_char = receive_queue.read());
+    else if (transfer_encoding.empty() && !content_length.empty()) {
+        receive_queue.read(write_, std::stoull(content_length));
+        complete_ = true;
+    }
+    else {
+        // Any other coding, or no length, is ended by closing the
+        // connection, so whether it is complete is unknown.
+        write_(buffer_ + receive_queue.begin(), 
+               receive_queue.waiting_for_reading());
+        for (int n;;) {
+            n = s->recv(buffer_, static_cast<int>(buffer_length_));
+            if (n <= 0)
                 break;
-            }
-            write_(&recv_char, 1);
-            -- chunk_len;
-            receive_queue.read(write_, chunk_len);
-            recv_char = receive_queue.read();
-
-            if (recv_char == '\r')
-                recv_char = receive_queue.read();
-            if (recv_char == '\n')
-                recv_char = receive_queue.read();
+            write_(buffer_, n);
         }
     }
 
@@ -23,6 +23,11 @@ public:
     size_t buffer_length_;
     
     HttpResponse resp_;
+    // Whether the status line and the header fields have been received.
+    bool head_received_ = false;
+    // Whether the body has been received to its end, without reading
+    // till the connection is closed, so the connection can be used again.
+    bool complete_ = false;
     std::function<size_t(void*,size_t)> write_;
 
 }; // class Receiver
@@ -1,7 +1,57 @@
 #include "EzNet/Socket/DatagramSocket.hpp"
 
+#include <cerrno>
+#include <stdexcept>
+
+#ifdef _LINUX
+#  include <netinet/udp.h>
+#endif // _LINUX
+
 namespace tab {
 
+#ifdef _LINUX
+// Datagrams passed to one sendmmsg() or recvmmsg(), whose headers are on 
+// the stack.
+#define MAX_BATCH 64
+// Segments of one UDP GSO buffer, limited by the kernel.
+#define MAX_GSO_SEGMENTS 64
+// Payload of one UDP GSO buffer, the limit of an IPv6 datagram.
+#define MAX_GSO_SIZE     (65535 - 8 - 40)
+
+namespace {
+
+// Room for the control message of UDP_SEGMENT (uint16_t) or UDP_GRO (int).
+union SegmentControl {
+    char    buf[CMSG_SPACE(sizeof(int))];
+    cmsghdr align;
+};
+
+void SetSegmentSize(msghdr& msg, SegmentControl& ctrl, size_t segment) {
+    msg.msg_control    = ctrl.buf;
+    msg.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+    cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_UDP;
+    cm->cmsg_type  = UDP_SEGMENT;
+    cm->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+    uint16_t size  = static_cast<uint16_t>(segment);
+    std::memcpy(CMSG_DATA(cm), &size, sizeof(size));
+}
+
+size_t GetSegmentSize(msghdr& msg) {
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr; 
+         cm = CMSG_NXTHDR(&msg, cm)) {
+        if (cm->cmsg_level == SOL_UDP && cm->cmsg_type == UDP_GRO) {
+            int size = 0;
+            std::memcpy(&size, CMSG_DATA(cm), sizeof(size));
+            return static_cast<size_t>(size);
+        }
+    }
+    return 0;
+}
+
+} // namespace
+#endif // _LINUX
+
 #ifdef _MSVC
 #pragma warning(push)
 #pragma warning(disable: 4267)
@@ -66,4 +116,191 @@ std::string DatagramSocket::recv(int limit) {
     return std::move(std::string(buf.get(), limit));
 }
 
+
+int DatagramSocket::sendBatch(const Datagram* packets, int count) {
+    int sent = 0;
+#ifdef _LINUX
+    mmsghdr msgs[MAX_BATCH];
+    iovec   iovs[MAX_BATCH];
+    SegmentControl ctrls[MAX_BATCH];
+    while (sent < count) {
+        int n = count - sent < MAX_BATCH ? count - sent : MAX_BATCH;
+        for (int i = 0; i < n; ++i) {
+            auto& p = packets[sent + i];
+            iovs[i].iov_base = p.buffer;
+            iovs[i].iov_len  = p.length;
+            msgs[i].msg_hdr  = msghdr{};
+            msgs[i].msg_hdr.msg_name    = const_cast<sockaddr_storage*>(&p.addr);
+            msgs[i].msg_hdr.msg_namelen = p.addr_len;
+            msgs[i].msg_hdr.msg_iov     = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen  = 1;
+            if (p.segment_size > 0 && p.segment_size < p.length)
+                SetSegmentSize(msgs[i].msg_hdr, ctrls[i], p.segment_size);
+        }
+        int r = sendmmsg(this->get(), msgs, n, 0);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        sent += r;
+        if (r < n) // would block
+            break;
+    }
+#else
+    for (; sent < count; ++sent) {
+        auto& p = packets[sent];
+        if (sendto(this->get(), p.buffer, static_cast<int>(p.length), 0, 
+                   reinterpret_cast<const sockaddr_t*>(&p.addr), 
+                   p.addr_len) < 0)
+            break;
+    }
+#endif // _LINUX
+    return sent > 0 || count == 0 ? sent : -1;
+}
+
+
+int DatagramSocket::recvBatch(Datagram* packets, int count, bool block) {
+    int got = 0;
+#ifdef _LINUX
+    mmsghdr msgs[MAX_BATCH];
+    iovec   iovs[MAX_BATCH];
+    SegmentControl ctrls[MAX_BATCH];
+    while (got < count) {
+        int n = count - got < MAX_BATCH ? count - got : MAX_BATCH;
+        for (int i = 0; i < n; ++i) {
+            auto& p = packets[got + i];
+            iovs[i].iov_base = p.buffer;
+            iovs[i].iov_len  = p.capacity;
+            msgs[i].msg_hdr  = msghdr{};
+            msgs[i].msg_hdr.msg_name    = &p.addr;
+            msgs[i].msg_hdr.msg_namelen = sizeof(p.addr);
+            msgs[i].msg_hdr.msg_iov     = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen  = 1;
+            if (gro_) {
+                msgs[i].msg_hdr.msg_control    = ctrls[i].buf;
+                msgs[i].msg_hdr.msg_controllen = sizeof(ctrls[i].buf);
+            }
+        }
+        // Only the first call may wait, for the first datagram.
+        int flags = block && got == 0 ? MSG_WAITFORONE : MSG_DONTWAIT;
+        int r = recvmmsg(this->get(), msgs, n, flags, nullptr);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return got > 0 ? got : -1;
+        }
+        for (int i = 0; i < r; ++i) {
+            auto& p = packets[got + i];
+            p.length    = msgs[i].msg_len;
+            p.addr_len  = msgs[i].msg_hdr.msg_namelen;
+            p.truncated = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+            p.segment_size = gro_ ? GetSegmentSize(msgs[i].msg_hdr) : 0;
+        }
+        got += r;
+        if (r < n) // no more datagram
+            break;
+    }
+#else
+    for (; got < count; ++got) {
+        if (!block || got > 0)
+            if (!this->readable(0))
+                break;
+        auto& p = packets[got];
+        socklen_t len = sizeof(p.addr);
+        int r = recvfrom(this->get(), p.buffer, static_cast<int>(p.capacity), 
+                         0, reinterpret_cast<sockaddr_t*>(&p.addr), &len);
+        p.truncated = r < 0 && WSAGetLastError() == WSAEMSGSIZE;
+        if (r < 0 && !p.truncated)
+            return got > 0 ? got : -1;
+        p.length   = p.truncated ? p.capacity : static_cast<size_t>(r);
+        p.addr_len = len;
+    }
+#endif // _LINUX
+    return got;
+}
+
+
+long long DatagramSocket::sendSegments(const Address& to, const void* buf, 
+                                       size_t size, size_t segment_size) {
+    // The size of a segment is passed to the kernel in 16 bits.
+    if (segment_size > 0xffff)
+        throw std::invalid_argument(
+            "tab::DatagramSocket::sendSegments(): "
+            "The segment size is larger than 65535.");
+    if (size == 0)
+        return 0;
+    if (segment_size == 0 || segment_size > size)
+        segment_size = size;
+    auto data = static_cast<const char*>(buf);
+    Datagram packet(const_cast<char*>(data), size);
+    packet.setAddress(to);
+    long long sent = 0;
+#ifdef _LINUX
+    size_t per_call = MAX_GSO_SIZE / segment_size;
+    if (per_call > MAX_GSO_SEGMENTS)
+        per_call = MAX_GSO_SEGMENTS;
+    while (!gso_failed_ && per_call > 1 && size > segment_size) {
+        size_t len = per_call * segment_size;
+        if (len > size)
+            len = size;
+        packet.buffer       = const_cast<char*>(data);
+        packet.length       = len;
+        packet.segment_size = segment_size;
+        if (sendBatch(&packet, 1) == 1) {
+            data += len;
+            size -= len;
+            sent += len;
+            continue;
+        }
+        // Not supported by the kernel or the device, 
+        // send them one by one instead.
+        if (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT || 
+            errno == EOPNOTSUPP)
+            gso_failed_ = true;
+        else
+            return sent > 0 ? sent : -1;
+    }
+#endif // _LINUX
+    // One datagram for each segment, sent in batches.
+    Datagram packets[16];
+    while (size > 0) {
+        int n = 0;
+        size_t len = 0;
+        for (; n < 16 && len < size; ++n) {
+            packets[n].buffer   = const_cast<char*>(data) + len;
+            packets[n].length   = size - len < segment_size ? 
+                                  size - len : segment_size;
+            packets[n].addr     = packet.addr;
+            packets[n].addr_len = packet.addr_len;
+            len += packets[n].length;
+        }
+        int r = sendBatch(packets, n);
+        if (r <= 0)
+            return sent > 0 ? sent : -1;
+        for (int i = 0; i < r; ++i) {
+            data += packets[i].length;
+            size -= packets[i].length;
+            sent += packets[i].length;
+        }
+    }
+    return sent;
+}
+
+
+bool DatagramSocket::enableGro(bool enable) {
+#ifdef _LINUX
+    int opt = enable ? 1 : 0;
+    if (setsockopt(this->get(), SOL_UDP, UDP_GRO, &opt, sizeof(opt)) != 0)
+        return false;
+    gro_ = enable;
+    return true;
+#else
+    (void)enable;
+    return false;
+#endif // _LINUX
+}
+
 } // namespace tab
\ No newline at end of file
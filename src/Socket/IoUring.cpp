@@ -0,0 +1,140 @@
+#include "IoUring.hpp"
+
+#ifdef _LINUX
+
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+namespace tab {
+
+static int SysIoUringSetup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int SysIoUringEnter(int fd, unsigned to_submit,
+                           unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                    min_complete, flags, nullptr, 0));
+}
+
+static int SysIoUringRegister(int fd, unsigned opcode,
+                              const void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode,
+                                    arg, nr_args));
+}
+
+
+bool IoUring::init(unsigned entries) {
+    release();
+
+    // Only the owner thread submits and waits, so the kernel can defer the
+    // completion work to io_uring_enter(2) instead of interrupting us.
+    // Older kernels reject these flags, try the plainer setups then.
+    const unsigned setup_flags[] = {
+        IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN,
+        IORING_SETUP_COOP_TASKRUN,
+        0
+    };
+    io_uring_params p;
+    for (unsigned flags : setup_flags) {
+        std::memset(&p, 0, sizeof(p));
+        p.flags = flags;
+        ring_fd_ = SysIoUringSetup(entries, &p);
+        if (ring_fd_ >= 0 || errno != EINVAL)
+            break;
+    }
+    if (ring_fd_ < 0)
+        return false;
+
+    sq_size_   = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_size_   = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+    bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        if (cq_size_ > sq_size_)
+            sq_size_ = cq_size_;
+        cq_size_ = sq_size_;
+    }
+
+    sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) {
+        sq_ptr_ = nullptr;
+        release();
+        return false;
+    }
+    if (single_mmap) {
+        cq_ptr_ = sq_ptr_;
+    }
+    else {
+        cq_ptr_ = mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED) {
+            cq_ptr_ = nullptr;
+            release();
+            return false;
+        }
+    }
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        release();
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(sq_ptr_);
+    sq_head_    = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sq_tail_    = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sq_mask_    = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sq_array_   = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    sq_entries_ = p.sq_entries;
+    sqe_tail_   = *sq_tail_;
+
+    char* cq = static_cast<char*>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes_    = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+    return true;
+} // IoUring::init()
+
+
+void IoUring::release() {
+    if (sqes_ != nullptr)
+        munmap(sqes_, sqes_size_);
+    if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_)
+        munmap(cq_ptr_, cq_size_);
+    if (sq_ptr_ != nullptr)
+        munmap(sq_ptr_, sq_size_);
+    if (ring_fd_ >= 0)
+        close(ring_fd_);
+    sqes_    = nullptr;
+    cq_ptr_  = nullptr;
+    sq_ptr_  = nullptr;
+    ring_fd_ = -1;
+} // IoUring::release()
+
+
+bool IoUring::registerBuffers(const iovec* bufs, unsigned n) {
+    return SysIoUringRegister(
+        ring_fd_, IORING_REGISTER_BUFFERS, bufs, n) == 0;
+}
+
+
+int IoUring::submit(unsigned wait_nr) {
+    unsigned to_submit = sqe_tail_ - *sq_tail_;
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int ret;
+    do {
+        ret = SysIoUringEnter(ring_fd_, to_submit, wait_nr, flags);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+} // IoUring::submit()
+
+} // namespace tab
+
+#endif // _LINUX
@@ -0,0 +1,138 @@
+#ifndef __IO_URING_HPP__
+#define __IO_URING_HPP__
+
+#include "EzNet/Basic/platform.h"
+
+#ifdef _LINUX
+
+#include <cstddef>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+namespace tab {
+
+/**
+ * @brief A minimal io_uring wrapper built on the raw system calls,
+ *        so that the backend does not depend on liburing.
+ *
+ * @note An object must only be used by the thread which initialized it.
+ */
+class IoUring {
+public:
+    IoUring() = default;
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    ~IoUring() {
+        release();
+    }
+
+    /**
+     * @brief Create the ring and map the queues.
+     *
+     * @param entries Size of the submission queue.
+     * @return false if io_uring is not available on this kernel.
+     */
+    bool init(unsigned entries);
+
+    void release();
+
+    /**
+     * @brief Register 'n' buffers, so that the fixed read/write
+     *        operations can skip mapping the user pages every time.
+     */
+    bool registerBuffers(const iovec* bufs, unsigned n);
+
+    /**
+     * @brief Get a cleared submission queue entry.
+     *
+     * @note The pending entries will be submitted automatically when
+     *       the submission queue is full.
+     */
+    io_uring_sqe* getSqe() {
+        io_uring_sqe* sqe = tryGetSqe();
+        if (sqe == nullptr) {
+            submit(0);
+            sqe = tryGetSqe();
+        }
+        return sqe;
+    }
+
+    /**
+     * @brief Submit all the pending entries, and wait for at least
+     *        'wait_nr' completions, in a single system call.
+     *
+     * @return The value returned by io_uring_enter(2).
+     */
+    int submit(unsigned wait_nr);
+
+    /**
+     * @brief Call 'f' with every completion available,
+     *        and mark them as consumed.
+     */
+    template <typename Func>
+    unsigned forEachCqe(Func f) {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        unsigned cnt  = 0;
+        for (; head != tail; ++head, ++cnt) {
+            // Copy it, then the slot can be reused as soon as
+            // 'f' submits a new request.
+            io_uring_cqe cqe = cqes_[head & *cq_mask_];
+            __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+            f(cqe);
+        }
+        return cnt;
+    }
+
+    int fd() const noexcept {
+        return ring_fd_;
+    }
+
+private:
+    io_uring_sqe* tryGetSqe() {
+        unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        if (sqe_tail_ - head >= sq_entries_)
+            return nullptr;
+        unsigned index = sqe_tail_ & *sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(io_uring_sqe));
+        sq_array_[index] = index;
+        ++ sqe_tail_;
+        return sqe;
+    }
+
+    int ring_fd_ = -1;
+
+    // Submission queue
+    unsigned*     sq_head_    = nullptr;
+    unsigned*     sq_tail_    = nullptr;
+    unsigned*     sq_mask_    = nullptr;
+    unsigned*     sq_array_   = nullptr;
+    unsigned      sq_entries_ = 0;
+    unsigned      sqe_tail_   = 0; // local tail, published by 'submit()'
+    io_uring_sqe* sqes_       = nullptr;
+
+    // Completion queue
+    unsigned*     cq_head_ = nullptr;
+    unsigned*     cq_tail_ = nullptr;
+    unsigned*     cq_mask_ = nullptr;
+    io_uring_cqe* cqes_    = nullptr;
+
+    // Mapped memory
+    void*  sq_ptr_    = nullptr;
+    size_t sq_size_   = 0;
+    void*  cq_ptr_    = nullptr;
+    size_t cq_size_   = 0;
+    size_t sqes_size_ = 0;
+
+}; // class IoUring
+
+} // namespace tab
+
+#endif // _LINUX
+
+#endif // __IO_URING_HPP__
@@ -2,15 +2,112 @@
 
 #ifdef EN_OPENSSL
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <functional>
+#include <vector>
+
+#include <openssl/rand.h>
+
+#ifdef _LINUX
+#  include <unistd.h>
+#endif
 
 namespace tab {
 
+namespace {
+
+// Sessions kept for each host.
+constexpr size_t SESSIONS_PER_HOST = 4;
+
+/**
+ * The data of an SSL_CTX, kept as its app data and freed with it, 
+ * since the sockets may outlive the 'SslContext's.
+ */
+struct SslContextData {
+    struct Entry {
+        // The newest at the end.
+        std::vector<SSL_SESSION*> sessions;
+        unsigned long long        used = 0;
+    };
+
+    ~SslContextData() {
+        for (auto& i : cache)
+            for (auto s : i.second.sessions)
+                SSL_SESSION_free(s);
+    }
+
+    std::mutex                   mutex;
+    size_t                       max_hosts = 256;
+    unsigned long long           clock = 0;
+    std::map<std::string, Entry> cache;
+    std::atomic<unsigned long long> full{ 0 };
+    std::atomic<unsigned long long> resumed{ 0 };
+};
+
+SslContextData* DataOf(SSL_CTX* ctx) {
+    return static_cast<SslContextData*>(SSL_CTX_get_app_data(ctx));
+}
+
+/**
+ * Called by OpenSSL when a session (or a ticket of TLS 1.3, which may 
+ * come after the handshake) is got. A copy is kept, since OpenSSL marks 
+ * the session of a connection closed without "close_notify" as not 
+ * resumable. Returns 0, so that OpenSSL keeps the ownership of 'session'.
+ */
+int KeepSession(SSL* ssl, SSL_SESSION* session) {
+    if (SSL_is_server(ssl))
+        return 0;
+    const char* host = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+    if (host == nullptr)
+        host = SSL_SESSION_get0_hostname(session);
+    auto data = DataOf(SSL_get_SSL_CTX(ssl));
+    if (host == nullptr || data == nullptr || 
+        !SSL_SESSION_is_resumable(session))
+        return 0;
+
+    std::lock_guard<std::mutex> lock(data->mutex);
+    if (data->max_hosts == 0)
+        return 0;
+    SSL_SESSION* copy = SSL_SESSION_dup(session);
+    if (copy == nullptr)
+        return 0;
+    auto it = data->cache.find(host);
+    if (it == data->cache.end()) {
+        if (data->cache.size() >= data->max_hosts) {
+            // The host used least recently is dropped.
+            auto oldest = data->cache.begin();
+            for (auto i = data->cache.begin(); i != data->cache.end(); ++i)
+                if (i->second.used < oldest->second.used)
+                    oldest = i;
+            for (auto s : oldest->second.sessions)
+                SSL_SESSION_free(s);
+            data->cache.erase(oldest);
+        }
+        it = data->cache.emplace(host, SslContextData::Entry()).first;
+    }
+    auto& entry = it->second;
+    entry.used = ++data->clock;
+    entry.sessions.push_back(copy);
+    if (entry.sessions.size() > SESSIONS_PER_HOST) {
+        SSL_SESSION_free(entry.sessions.front());
+        entry.sessions.erase(entry.sessions.begin());
+    }
+    return 0;
+}
+
+} // namespace
+
+
 static std::function<void(SSL_CTX*)> SSL_CTX_deleter([](SSL_CTX* ptr){
-    if (ptr)
+    if (ptr) {
+        delete DataOf(ptr);
         SSL_CTX_free(ptr);
+    }
 });
 
 static std::function<void(SSL*)> SSL_deleter([](SSL* ptr){
@@ -26,7 +123,12 @@ SslContext::SslContext() {
         throw SslLibraryException(
             "tab::SslContext::SslContext(): "
             "Unable to create an new SSL_CTX object.");
+    SSL_CTX_set_app_data(pCtx, new SslContextData);
     context_.reset(pCtx, SSL_CTX_deleter);
+    // The sessions are kept in 'SslContextData' instead of OpenSSL.
+    SSL_CTX_set_session_cache_mode(
+        pCtx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(pCtx, KeepSession);
 } // SslContext::SslContext(ProtocolVersion)
 
 
@@ -37,10 +139,84 @@ SslContext::SslContext(SslContext&& ctx) :
     context_(std::move(ctx.context_)) { }
 
 
+void SslContext::setSessionCacheSize(size_t hosts) {
+    auto data = DataOf(context_.get());
+    std::lock_guard<std::mutex> lock(data->mutex);
+    data->max_hosts = hosts;
+    while (data->cache.size() > hosts) {
+        for (auto s : data->cache.begin()->second.sessions)
+            SSL_SESSION_free(s);
+        data->cache.erase(data->cache.begin());
+    }
+}
+
+
+void SslContext::enableServerSessionCache(long size, long timeout_seconds) {
+    auto ctx = context_.get();
+    SSL_CTX_set_session_cache_mode(
+        ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_CLIENT);
+    SSL_CTX_sess_set_cache_size(ctx, size);
+    SSL_CTX_set_timeout(ctx, timeout_seconds);
+    static const unsigned char id_context[] = "EzNet";
+    SSL_CTX_set_session_id_context(ctx, id_context, sizeof(id_context) - 1);
+}
+
+
+void SslContext::setTicketKeys(const std::string& keys) {
+    if (keys.size() != 80 || 
+        SSL_CTX_set_tlsext_ticket_keys(
+            context_.get(), (void*)keys.data(), (long)keys.size()) != 1) {
+        throw std::runtime_error(
+            "tab::SslContext::setTicketKeys(): "
+            "The keys must be 80 bytes.");
+    }
+}
+
+
+std::string SslContext::GenerateTicketKeys() {
+    std::string keys(80, '\0');
+    if (RAND_bytes((unsigned char*)&keys[0], (int)keys.size()) != 1)
+        throw SslLibraryException(
+            "tab::SslContext::GenerateTicketKeys(): "
+            "Unable to generate random bytes.");
+    return keys;
+}
+
+
+bool SslContext::enableKernelTls(bool enable) {
+#ifdef EN_KTLS
+    if (enable)
+        SSL_CTX_set_options(context_.get(), SSL_OP_ENABLE_KTLS);
+    else
+        SSL_CTX_clear_options(context_.get(), SSL_OP_ENABLE_KTLS);
+    return true;
+#else
+    (void)enable;
+    return false;
+#endif
+}
+
+
+SslContext::HandshakeStats SslContext::getHandshakeStats() const {
+    auto ctx = context_.get();
+    auto data = DataOf(ctx);
+    HandshakeStats ret;
+    ret.client_full    = data->full.load(std::memory_order_relaxed);
+    ret.client_resumed = data->resumed.load(std::memory_order_relaxed);
+    long accepted = SSL_CTX_sess_accept_good(ctx);
+    long hits = SSL_CTX_sess_hits(ctx);
+    ret.server_resumed = static_cast<unsigned long long>(hits);
+    ret.server_full = static_cast<unsigned long long>(
+        accepted > hits ? accepted - hits : 0);
+    return ret;
+}
+
+
 SecureSocket::SecureSocket(SecureSocket&& ss) :
     _Base(std::move(ss)),
     ssl_context_(std::move(ss.ssl_context_)),
-    ssl_(std::move(ss.ssl_)) {
+    ssl_(std::move(ss.ssl_)),
+    ktls_send_(ss.ktls_send_) {
 
 } // SecureSocket::SecureSocket(SecureSocket&&)
 
@@ -100,8 +276,16 @@ bool SecureSocket::connect(const Address& target,
             std::string("tab::SecureSocket::connect():(OpenSSL) ")
              + err_info);
     }
-        
 
+#ifdef EN_KTLS
+    ktls_send_ = BIO_get_ktls_send(SSL_get_wbio(ssl_.get()));
+#endif
+
+    auto data = DataOf(ssl_context_.get());
+    if (SSL_session_reused(ssl_.get()))
+        data->resumed.fetch_add(1, std::memory_order_relaxed);
+    else
+        data->full.fetch_add(1, std::memory_order_relaxed);
     return true;
 } //SecureSocket::connect(const Address&, const time_t, const size_t)
 #ifdef _MSVC
@@ -109,10 +293,36 @@ bool SecureSocket::connect(const Address& target,
 #endif
 
 
+void SecureSocket::setHostName(const std::string& host) {
+    SSL_set_tlsext_host_name(ssl_.get(), host.c_str());
+    auto data = DataOf(ssl_context_.get());
+    std::lock_guard<std::mutex> lock(data->mutex);
+    auto it = data->cache.find(host);
+    if (it == data->cache.end())
+        return;
+    auto& entry = it->second;
+    entry.used = ++data->clock;
+    SSL_SESSION* session = entry.sessions.back();
+    SSL_set_session(ssl_.get(), session);
+    // A ticket of TLS 1.3 should be used only once, 
+    // while a session of TLS 1.2 can be used again.
+    if (SSL_SESSION_get_protocol_version(session) >= TLS1_3_VERSION) {
+        SSL_SESSION_free(session);
+        entry.sessions.pop_back();
+        if (entry.sessions.empty())
+            data->cache.erase(it);
+    }
+}
+
+
 int SecureSocket::send(const char* buf, int size, bool block) {
     if (!block)
         if (!this->writable())
             return 0;
+    // The records are made by the kernel, and OpenSSL has nothing more 
+    // to do than sending the data.
+    if (ktls_send_)
+        return _Base::send(buf, size, true);
     return SSL_write(ssl_.get(), buf, size);
 } // SecureSocket::send(const char*, int, bool)
 
@@ -125,6 +335,46 @@ int SecureSocket::recv(void* buf, int size, bool block) {
 } // SecureSocket::recv(void*, int, bool) 
 
 
+bool SecureSocket::kernelTlsRecv() const noexcept {
+#ifdef EN_KTLS
+    return BIO_get_ktls_recv(SSL_get_rbio(ssl_.get()));
+#else
+    return false;
+#endif
+}
+
+
+#ifdef _LINUX
+long long SecureSocket::sendFile(int fd, off_t offset, size_t size) {
+    long long sent = 0;
+#ifdef EN_KTLS
+    if (ktls_send_) {
+        while (size > 0) {
+            auto n = SSL_sendfile(ssl_.get(), fd, offset, size, 0);
+            if (n <= 0)
+                return sent > 0 ? sent : -1;
+            sent += n;
+            offset += n;
+            size -= n;
+        }
+        return sent;
+    }
+#endif
+    constexpr size_t BUFFER_SIZE = 16384; // A record at most
+    std::unique_ptr<char[]> buffer(new char[BUFFER_SIZE]);
+    while (size > 0) {
+        auto n = pread(fd, buffer.get(), std::min(size, BUFFER_SIZE), offset);
+        if (n <= 0 || SSL_write(ssl_.get(), buffer.get(), (int)n) <= 0)
+            return sent > 0 ? sent : -1;
+        sent += n;
+        offset += n;
+        size -= n;
+    }
+    return sent;
+} // SecureSocket::sendFile(int, off_t, size_t)
+#endif
+
+
 std::string SecureSocket::recv(int buffer_size, bool block) {
     std::unique_ptr<char[]> buffer(new char[buffer_size]{});
     if (this->recv(buffer.get(), buffer_size, block) > 0)
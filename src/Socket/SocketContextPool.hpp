@@ -0,0 +1,272 @@
+#ifndef __SOCKET_CONTEXT_POOL_HPP__
+#define __SOCKET_CONTEXT_POOL_HPP__
+
+#include "EzNet/Basic/platform.h"
+
+#ifdef _LINUX
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#include "TcpServerEventsInternal.hpp"
+
+namespace tab {
+
+/**
+ * @brief Recycles the 'SocketContext' objects of one handler thread.
+ *
+ * The first 'prewarm' contexts are constructed in one mapping when the
+ * pool is created (the io_uring backend registers it to the kernel as
+ * a whole). When they are used up, more contexts are allocated, and at
+ * most 'capacity' idle contexts are kept for later connections. So once
+ * the pool has grown to the working set, accepting and closing
+ * connections allocate nothing.
+ *
+ * The pool also keeps the timers of the thread, where the deadline of
+ * every connection in use is armed for what it is waiting for: the next
+ * request ('WAIT_IDLE', also the TLS handshake), the rest of a request
+ * ('WAIT_READ', from the first data received, so a request trickling in
+ * is not kept alive by every byte), or the peer reading what is written
+ * ('WAIT_WRITE', renewed whenever some data are sent). An expired
+ * connection is shut down, which fails its pending operation.
+ *
+ * @note Only the owner thread may acquire and release the contexts,
+ *       the counters can be read by any thread.
+ */
+class SocketContextPool {
+public:
+    SocketContextPool(TcpServer::TcpEventMatcher& m, 
+                      size_t prewarm, size_t capacity) :
+        matcher_(m),
+        capacity_(capacity < prewarm ? prewarm : capacity) {
+        slab_size_ = prewarm * sizeof(SocketContext);
+        if (slab_size_ == 0)
+            return;
+        void* mem = mmap(nullptr, slab_size_, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (mem == MAP_FAILED)
+            throw std::runtime_error(
+                "tab::SocketContextPool::SocketContextPool(): "
+                "Failed to allocate the pre-warmed contexts.");
+        slab_begin_ = static_cast<SocketContext*>(mem);
+        slab_end_   = slab_begin_ + prewarm;
+        for (size_t i = prewarm; i > 0; --i)
+            pushFree(new (slab_begin_ + (i - 1)) SocketContext(matcher_));
+    }
+
+#ifdef EN_OPENSSL
+    /**
+     * Give each context an SSL object of 'tls', which is created when the
+     * context is acquired the first time, and kept when it is released.
+     */
+    void setTlsContext(SSL_CTX* tls) {
+        tls_ = tls;
+    }
+#endif // EN_OPENSSL
+
+    /**
+     * The timeouts of the states in milliseconds, 0 for none.
+     */
+    void setTimeouts(unsigned long long idle, unsigned long long read,
+                     unsigned long long write) {
+        timeouts_[SocketContext::WAIT_IDLE]  = idle;
+        timeouts_[SocketContext::WAIT_READ]  = read;
+        timeouts_[SocketContext::WAIT_WRITE] = write;
+    }
+
+    SocketContextPool(const SocketContextPool&) = delete;
+    SocketContextPool& operator=(const SocketContextPool&) = delete;
+
+    /**
+     * Frees all the contexts. The connections are expected to be closed
+     * by 'closeAll()' in the owner thread.
+     */
+    ~SocketContextPool() {
+        while (used_ != nullptr) {
+            SocketContext* ctx = used_;
+            used_ = ctx->next;
+            destroy(ctx);
+        }
+        while (free_ != nullptr) {
+            SocketContext* ctx = free_;
+            free_ = ctx->next;
+            destroy(ctx);
+        }
+        if (slab_begin_ != nullptr)
+            munmap(slab_begin_, slab_size_);
+    }
+
+    SocketContext* acquire() {
+        SocketContext* ctx = free_;
+        if (ctx != nullptr) {
+            free_ = ctx->next;
+            -- free_count_;
+            hits_.fetch_add(1, std::memory_order_relaxed);
+        }
+        else {
+            ctx = new SocketContext(matcher_);
+            misses_.fetch_add(1, std::memory_order_relaxed);
+        }
+#ifdef EN_OPENSSL
+        // If SSL_new() fails, 'ssl' is null and the connection is closed
+        // by the handshake.
+        if (tls_ != nullptr) {
+            if (ctx->ssl == nullptr)
+                ctx->ssl = SSL_new(tls_);
+            ctx->tls_state = SocketContext::TLS_HANDSHAKE;
+        }
+#endif // EN_OPENSSL
+        ctx->pool = this;
+        armDeadline(ctx, SocketContext::WAIT_IDLE);
+        ctx->prev = nullptr;
+        ctx->next = used_;
+        if (used_ != nullptr)
+            used_->prev = ctx;
+        used_ = ctx;
+        return ctx;
+    }
+
+    /**
+     * Give back a context whose socket has been closed.
+     */
+    void release(SocketContext* ctx) {
+        ctx->deadline.cancel();
+        ctx->wait_state = SocketContext::WAIT_NONE;
+        if (ctx->prev != nullptr)
+            ctx->prev->next = ctx->next;
+        else
+            used_ = ctx->next;
+        if (ctx->next != nullptr)
+            ctx->next->prev = ctx->prev;
+
+        if (free_count_ >= capacity_ && !inSlab(ctx)) {
+            destroy(ctx);
+            return;
+        }
+#ifdef EN_OPENSSL
+        // Much cheaper than SSL_new(), the buffers are kept.
+        if (ctx->ssl != nullptr && SSL_clear(ctx->ssl) != 1) {
+            SSL_free(ctx->ssl);
+            ctx->ssl = nullptr;
+        }
+        ctx->tls_state = SocketContext::TLS_NONE;
+#endif // EN_OPENSSL
+        ctx->recycle();
+        pushFree(ctx);
+    }
+
+    /**
+     * Close the connection of 'ctx', and give back the context.
+     * 'ConnectionClosedEvent' is dispatched for an accepted connection.
+     */
+    void close(SocketContext* ctx) {
+#ifdef EN_OPENSSL
+        // Send "close_notify" without waiting for the answer.
+        if (ctx->tls_state == SocketContext::TLS_ESTABLISHED)
+            SSL_shutdown(ctx->ssl);
+        // The handshake did not finish, so the connection was not accepted.
+        if (ctx->tls_state == SocketContext::TLS_HANDSHAKE) {
+            _close(ctx->socket);
+            release(ctx);
+            return;
+        }
+#endif // EN_OPENSSL
+        // Closing the descriptor also removes it from the epoll set.
+        _close(ctx->socket);
+        ConnectionClosedEventInternal event(*ctx);
+        ConnectionClosedEventInternal::Handler(event);
+        release(ctx);
+    }
+
+    /**
+     * Close the connections which are still open, when the thread stops.
+     */
+    void closeAll() {
+        while (used_ != nullptr)
+            close(used_);
+    }
+
+    /**
+     * (Re)arm the deadline of the connection for 'state'.
+     */
+    void armDeadline(SocketContext* ctx, SocketContext::WaitState state) {
+        ctx->wait_state = state;
+        if (timeouts_[state] != 0)
+            timers_.arm(ctx->deadline, timeouts_[state]);
+        else
+            ctx->deadline.cancel();
+    }
+
+    TimerWheel& timers() {
+        return timers_;
+    }
+
+    bool inSlab(const void* p) const {
+        return p >= static_cast<const void*>(slab_begin_) &&
+               p <  static_cast<const void*>(slab_end_);
+    }
+
+    // The mapping of the pre-warmed contexts, empty if there is none.
+    iovec slab() const {
+        return iovec{slab_begin_, slab_size_};
+    }
+
+    unsigned long long hits() const {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    unsigned long long misses() const {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void pushFree(SocketContext* ctx) {
+        ctx->prev = nullptr;
+        ctx->next = free_;
+        free_ = ctx;
+        ++ free_count_;
+    }
+
+    void destroy(SocketContext* ctx) {
+#ifdef EN_OPENSSL
+        if (ctx->ssl != nullptr)
+            SSL_free(ctx->ssl);
+#endif // EN_OPENSSL
+        if (inSlab(ctx))
+            ctx->~SocketContext();
+        else
+            delete ctx;
+    }
+
+    TcpServer::TcpEventMatcher& matcher_;
+    size_t         capacity_;
+    SocketContext* slab_begin_ = nullptr;
+    SocketContext* slab_end_   = nullptr;
+    size_t         slab_size_  = 0;
+    // Singly linked by 'SocketContext::next'.
+    SocketContext* free_       = nullptr;
+    size_t         free_count_ = 0;
+    // Doubly linked, so a context can leave it in constant time.
+    SocketContext* used_       = nullptr;
+    TimerWheel     timers_;
+    // Indexed by 'SocketContext::WaitState'.
+    unsigned long long timeouts_[4] = {};
+
+#ifdef EN_OPENSSL
+    SSL_CTX*       tls_        = nullptr;
+#endif // EN_OPENSSL
+
+    std::atomic<unsigned long long> hits_{0};
+    std::atomic<unsigned long long> misses_{0};
+
+}; // class SocketContextPool
+
+} // namespace tab
+
+#endif // _LINUX
+
+#endif // __SOCKET_CONTEXT_POOL_HPP__
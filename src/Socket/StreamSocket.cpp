@@ -35,7 +35,13 @@ int StreamSocket::send(const char* buf, int size, bool block) {
         if (!block)
             if (!this->writable())
                 return 0;
+#ifdef _LINUX
+        // A connection closed by the peer must not raise SIGPIPE, which
+        // can happen to the connections kept alive by the HTTP client.
+        return _send(this->get(), buf, size, MSG_NOSIGNAL);
+#else
         return _send(this->get(), buf, size);
+#endif
     }
     return -1;
 }
@@ -1,8 +1,23 @@
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <cstring>
 #include <iostream>
+#include <type_traits>
 
 #include "EzNet/Socket/TcpServer.hpp"
 #include "TcpServerEventsInternal.hpp"
+#include "SocketContextPool.hpp"
+
+#ifdef _WINDOWS
+#  include <io.h>
+#endif // _WINDOWS
+#ifdef _LINUX
+#  include <signal.h>
+#  include <sys/epoll.h>
+#  include <sys/eventfd.h>
+#  include <sys/sendfile.h>
+#endif // _LINUX
 
 namespace tab {
 
@@ -35,39 +50,61 @@ void PostAcceptRequest(ServerSocket* server, SocketContext* ctx) {
     }
 }
 
+/**
+ * Read the segment of a file into 'out', the rest of which is zeroed if 
+ * the file is shorter than the segment.
+ */
+void ReadFileSegment(const OutputSegment& seg, char* out) {
+    size_t done = 0;
+    if (_lseeki64(seg.file, static_cast<__int64>(seg.offset), SEEK_SET) >= 0) {
+        while (done < seg.size) {
+            int n = _read(seg.file, out + done, static_cast<unsigned>(
+                std::min<size_t>(seg.size - done, INT_MAX)));
+            if (n <= 0)
+                break;
+            done += static_cast<size_t>(n);
+        }
+    }
+    std::memset(out + done, 0, seg.size - done);
+}
+
+void CloseConnection(SocketContext* ctx) {
+    closesocket(ctx->socket);
+    ConnectionClosedEventInternal event(*ctx);
+    ConnectionClosedEventInternal::Handler(event);
+    delete ctx;
+}
+
 void PostIORequest(SocketContext* ctx) {
     switch(ctx->operation_required) {
         case TcpServerEvent::OP_WRITE: {// if writing operation is needed
             if (WSASend(
                     ctx->socket, 
-                    &ctx->wsabuf, 
+                    &ctx->iobuf, 
                     1, 
                     NULL, 
                     0, 
                     &ctx->overlapped, 
                     NULL) != 0 && 
                 WSAGetLastError() != ERROR_IO_PENDING) {
-                closesocket(ctx->socket);
-                delete ctx;
+                CloseConnection(ctx);
             }
             break;
         }
         case TcpServerEvent::OP_READ: {// if reading operation is needed
         DWORD flags = 0;
-        if (WSARecv(ctx->socket, &ctx->wsabuf, 1, NULL, &flags,
+        if (WSARecv(ctx->socket, &ctx->iobuf, 1, NULL, &flags,
                     &ctx->overlapped, NULL) != 0) {
             auto err = WSAGetLastError();
             if (err != ERROR_IO_PENDING) {
                 std::cerr << "WSARecv() ERROR: " << err << std::endl;
-                closesocket(ctx->socket);
-                delete ctx;
+                CloseConnection(ctx);
             }
         }
             break;
         }
         default: { // closing operation is needed
-            closesocket(ctx->socket);
-            delete ctx;
+            CloseConnection(ctx);
         }
     }
 }
@@ -75,7 +112,420 @@ void PostIORequest(SocketContext* ctx) {
 #endif // _WINDOWS
 
 
-void HandlerThread(TcpServer& s) {
+#ifdef _LINUX
+
+#define MAX_EPOLL_EVENTS 256
+// Segments passed to one sendmsg().
+#define MAX_WRITE_SEGMENTS 64
+// Bytes which sendfile(2) transfers at most in one call.
+#define MAX_SENDFILE_SIZE  0x7ffff000UL
+// Bytes of a file encrypted by one SSL_write(), a TLS record at most.
+#define TLS_FILE_CHUNK     16384
+
+/**
+ * Milliseconds of a timeout of 'TcpConfig', 0 for none.
+ */
+unsigned long long TimeoutOf(int seconds, int fallback) {
+    if (seconds == 0)
+        seconds = fallback;
+    if (seconds <= 0 || seconds == INT_MAX)
+        return 0;
+    return static_cast<unsigned long long>(seconds) * 1000;
+}
+
+void CloseConnection(SocketContext* ctx) {
+    ctx->pool->close(ctx);
+}
+
+#ifdef EN_OPENSSL
+/**
+ * 'DriveConnection()' of a TLS connection. OpenSSL reads and writes the 
+ * socket, and the handlers see the decrypted data only.
+ * 
+ * The handshake is driven first, and 'ConnectionAcceptedEvent' is 
+ * dispatched once it finishes. Either direction of the socket may be 
+ * needed by any operation of OpenSSL (e.g. a KeyUpdate while reading), and
+ * the connection is watched for both, so it waits for the next event 
+ * whenever OpenSSL wants to read or write.
+ */
+void DriveTlsConnection(SocketContext* ctx) {
+    SSL* ssl = ctx->ssl;
+    bool sent = false;
+    if (ctx->tls_state == SocketContext::TLS_HANDSHAKE) {
+        if (ssl == nullptr) {
+            CloseConnection(ctx);
+            return;
+        }
+        int r = SSL_do_handshake(ssl);
+        if (r != 1) {
+            int err = SSL_get_error(ssl, r);
+            if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE)
+                CloseConnection(ctx);
+            return;
+        }
+        ctx->tls_state = SocketContext::TLS_ESTABLISHED;
+        // The context of the listener is only used on Windows.
+        ConnectionAcceptedEventInternal event(*ctx, *ctx);
+        ConnectionAcceptedEventInternal::Handler(event);
+    }
+
+    for (;;) {
+        int n = 0;
+        switch (ctx->operation_required) {
+        case TcpServerEvent::OP_READ: {
+            n = SSL_read(ssl, ctx->iobuf.buf, static_cast<int>(ctx->iobuf.len));
+            if (n > 0) {
+                DataReceivedEventInternal event(*ctx);
+                if (ctx->iobuf.buf == ctx->buffer_add)
+                    ctx->content_length_add = static_cast<unsigned long>(n);
+                else
+                    ctx->content_length = static_cast<unsigned long>(n);
+                DataReceivedEventInternal::Handler(event);
+                continue;
+            }
+            break;
+        }
+        case TcpServerEvent::OP_WRITE: {
+            unsigned long total = ctx->segments != nullptr ? 
+                ctx->segments_size : ctx->iobuf.len;
+            unsigned long left = total - ctx->transferred;
+            // SSL_MODE_ENABLE_PARTIAL_WRITE is set, like send(). The 
+            // segments are written one by one.
+            iovec next{ ctx->iobuf.buf + ctx->transferred, left };
+            size_t done = 0;
+            const OutputSegment* file = nullptr;
+            if (ctx->segments != nullptr) {
+                file = ctx->pendingSegment(done);
+                if (file != nullptr && file->file == -1) {
+                    file = nullptr;
+                    ctx->pendingSegments(&next, 1);
+                }
+            }
+            if (file != nullptr) {
+                size_t size = file->size - done;
+                unsigned long long offset = file->offset + done;
+#ifdef EN_KTLS
+                // Encrypted by the kernel, the file is not read here.
+                if (BIO_get_ktls_send(SSL_get_wbio(ssl))) {
+                    n = static_cast<int>(SSL_sendfile(
+                        ssl, file->file, static_cast<off_t>(offset), 
+                        std::min<size_t>(size, MAX_SENDFILE_SIZE), 0));
+                }
+                else
+#endif // EN_KTLS
+                {
+                    // A write to be retried is read again with the same
+                    // offset and size, so OpenSSL gets the same data.
+                    thread_local char chunk[TLS_FILE_CHUNK];
+                    ssize_t r = ::pread(
+                        file->file, chunk, std::min(size, sizeof(chunk)), 
+                        static_cast<off_t>(offset));
+                    if (r <= 0) { // the file is shorter than the segment
+                        CloseConnection(ctx);
+                        return;
+                    }
+                    n = SSL_write(ssl, chunk, static_cast<int>(r));
+                }
+            }
+            else if (left > 0) {
+                n = SSL_write(ssl, next.iov_base, 
+                              static_cast<int>(next.iov_len));
+            }
+            if (n > 0 || left == 0) {
+                ctx->transferred += static_cast<unsigned long>(n);
+                if (ctx->transferred < total) {
+                    sent = true;
+                    continue;
+                }
+                ctx->transferred = 0;
+                DataSentEventInternal event(*ctx);
+                DataSentEventInternal::Handler(event);
+                continue;
+            }
+            break;
+        }
+        default: { // closing operation is needed
+            CloseConnection(ctx);
+            return;
+        }
+        }
+        int err = SSL_get_error(ssl, n);
+        if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) {
+            // Still writing, but the peer took something.
+            if (sent && ctx->operation_required == TcpServerEvent::OP_WRITE)
+                ctx->pool->armDeadline(ctx, SocketContext::WAIT_WRITE);
+            return;
+        }
+        // SSL_shutdown() must not be called after a fatal error.
+        if (err != SSL_ERROR_ZERO_RETURN)
+            ctx->tls_state = SocketContext::TLS_FAILED;
+        CloseConnection(ctx);
+        return;
+    }
+}
+
+/**
+ * Select the first protocol of the server (in the wire format, 'arg') 
+ * offered by the client.
+ */
+int SelectAlpn(SSL*, const unsigned char** out, unsigned char* outlen, 
+               const unsigned char* in, unsigned int inlen, void* arg) {
+    auto& wire = *static_cast<std::string*>(arg);
+    unsigned char* selected = nullptr;
+    if (SSL_select_next_proto(
+            &selected, outlen, 
+            reinterpret_cast<const unsigned char*>(wire.data()), 
+            static_cast<unsigned int>(wire.size()), 
+            in, inlen) != OPENSSL_NPN_NEGOTIATED)
+        return SSL_TLSEXT_ERR_NOACK;
+    *out = selected;
+    return SSL_TLSEXT_ERR_OK;
+}
+#endif // EN_OPENSSL
+
+/**
+ * Performs the operation required by 'ctx' until it would block.
+ * 
+ * The connections are registered edge-triggered, so an operation must be 
+ * retried until the kernel returns EAGAIN before waiting for the next 
+ * readiness notification. Every completed operation dispatches the same 
+ * events as a completion packet does on IOCP.
+ */
+void DriveConnection(SocketContext* ctx) {
+#ifdef EN_OPENSSL
+    if (ctx->tls_state != SocketContext::TLS_NONE) {
+        DriveTlsConnection(ctx);
+        return;
+    }
+#endif // EN_OPENSSL
+    bool sent = false;
+    for (;;) {
+        switch (ctx->operation_required) {
+        case TcpServerEvent::OP_READ: {
+            ssize_t n = ::recv(ctx->socket, ctx->iobuf.buf, ctx->iobuf.len, 0);
+            if (n > 0) {
+                DataReceivedEventInternal event(*ctx);
+                if (ctx->iobuf.buf == ctx->buffer_add)
+                    ctx->content_length_add = static_cast<unsigned long>(n);
+                else
+                    ctx->content_length = static_cast<unsigned long>(n);
+                DataReceivedEventInternal::Handler(event);
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return; // wait for the next EPOLLIN
+            CloseConnection(ctx); // peer closed or error occurred
+            return;
+        }
+        case TcpServerEvent::OP_WRITE: {
+            unsigned long total = ctx->iobuf.len;
+            ssize_t n;
+            size_t done = 0;
+            const OutputSegment* file = nullptr;
+            if (ctx->segments != nullptr) {
+                total = ctx->segments_size;
+                file = ctx->pendingSegment(done);
+                if (file != nullptr && file->file == -1)
+                    file = nullptr;
+            }
+            if (file != nullptr) {
+                // From the page cache to the socket, in the kernel.
+                off_t offset = static_cast<off_t>(file->offset + done);
+                n = ::sendfile(ctx->socket, file->file, &offset, 
+                               std::min<size_t>(file->size - done, 
+                                                MAX_SENDFILE_SIZE));
+                if (n == 0) { // the file is shorter than the segment
+                    CloseConnection(ctx);
+                    return;
+                }
+            }
+            else if (ctx->segments != nullptr) {
+                iovec iov[MAX_WRITE_SEGMENTS];
+                msghdr msg{};
+                bool file_next = false;
+                msg.msg_iov    = iov;
+                msg.msg_iovlen = ctx->pendingSegments(
+                    iov, MAX_WRITE_SEGMENTS, &file_next);
+                // Like TCP_CORK, the last partial packet waits for the 
+                // file following, instead of being sent alone.
+                n = ::sendmsg(ctx->socket, &msg, 
+                              MSG_NOSIGNAL | (file_next ? MSG_MORE : 0));
+            }
+            else {
+                n = ::send(ctx->socket, 
+                           ctx->iobuf.buf + ctx->transferred, 
+                           ctx->iobuf.len - ctx->transferred, 
+                           MSG_NOSIGNAL);
+            }
+            if (n >= 0) {
+                ctx->transferred += static_cast<unsigned long>(n);
+                if (ctx->transferred < total) {
+                    sent = true;
+                    continue;
+                }
+                ctx->transferred = 0;
+                DataSentEventInternal event(*ctx);
+                DataSentEventInternal::Handler(event);
+                continue;
+            }
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // The peer took something, renew the deadline.
+                if (sent)
+                    ctx->pool->armDeadline(ctx, SocketContext::WAIT_WRITE);
+                return; // wait for the next EPOLLOUT
+            }
+            CloseConnection(ctx);
+            return;
+        }
+        default: { // closing operation is needed
+            CloseConnection(ctx);
+            return;
+        }
+        }
+    }
+}
+
+void AcceptConnections(int epfd, SocketContext* acceptor, 
+                       SocketContextPool& pool) {
+    for (;;) {
+        socket_t client_socket = accept4(acceptor->socket, nullptr, nullptr, 
+                                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                std::cerr 
+                    << "tab::AcceptConnections(): accept4() failed, error: "
+                    << errno << "." << std::endl;
+            return;
+        }
+
+        auto ctx_new = pool.acquire();
+        ctx_new->socket = client_socket;
+
+        // Registered once for both directions, 'DriveConnection()' decides
+        // what to do according to the operation required.
+        epoll_event ev{};
+        ev.events   = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = ctx_new;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, client_socket, &ev) != 0) {
+            CloseConnection(ctx_new);
+            continue;
+        }
+
+#ifdef EN_OPENSSL
+        // The connection is accepted after the handshake.
+        if (ctx_new->tls_state != SocketContext::TLS_NONE) {
+            if (ctx_new->ssl != nullptr) {
+                SSL_set_fd(ctx_new->ssl, client_socket);
+                SSL_set_accept_state(ctx_new->ssl);
+            }
+            DriveConnection(ctx_new);
+            continue;
+        }
+#endif // EN_OPENSSL
+
+        ConnectionAcceptedEventInternal event(*acceptor, *ctx_new);
+        ConnectionAcceptedEventInternal::Handler(event);
+
+        DriveConnection(ctx_new);
+    }
+}
+
+void EpollHandlerThread(SocketContext* acceptor, int stop_fd, 
+                        SocketContextPool& pool) {
+    // Every handler thread owns an epoll instance. The listening socket is 
+    // shared by all of them (EPOLLEXCLUSIVE avoids waking every thread for 
+    // one connection), and an accepted connection stays in the epoll set of 
+    // the thread which accepted it, so no two threads touch one connection.
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        std::cerr 
+            << "tab::EpollHandlerThread(): epoll_create1() failed, error: "
+            << errno << "." << std::endl;
+        return;
+    }
+
+    epoll_event ev{};
+    ev.events   = EPOLLIN | EPOLLEXCLUSIVE;
+    ev.data.ptr = acceptor;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, acceptor->socket, &ev) != 0) {
+        std::cerr 
+            << "tab::EpollHandlerThread(): Failed to watch the server socket, "
+            "error: " << errno << "." << std::endl;
+        _close(epfd);
+        return;
+    }
+    // Level-triggered and never read, so that it wakes all the threads.
+    ev.events   = EPOLLIN;
+    ev.data.ptr = nullptr;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, stop_fd, &ev);
+
+    epoll_event events[MAX_EPOLL_EVENTS];
+    TimerWheel& timers = pool.timers();
+    for (bool running = true; running;) {
+        int n = epoll_wait(epfd, events, MAX_EPOLL_EVENTS, 
+                           timers.nextTimeout());
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            std::cerr 
+                << "tab::EpollHandlerThread(): epoll_wait() failed, error: "
+                << errno << "." << std::endl;
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            auto socket_ctx = (SocketContext*)events[i].data.ptr;
+            if (socket_ctx == nullptr) // should exit
+                running = false;
+            else if (socket_ctx == acceptor) // new connection arrived
+                AcceptConnections(epfd, acceptor, pool);
+            else
+                DriveConnection(socket_ctx);
+        }
+        // The connections expired are shut down, and closed by the 
+        // events of the next round.
+        timers.advance();
+    }
+    _close(epfd);
+    // In this thread, as the handlers of the connections expect.
+    pool.closeAll();
+} // EpollHandlerThread()
+
+
+ServerSocket* OpenListener(const TcpServer::TcpConfig& cfg) {
+    std::unique_ptr<ServerSocket> listener(
+        new ServerSocket(cfg.listen_address.getAddr().getAF()));
+
+    int opt = 1;
+    listener->setOpt(SOL_SOCKET, SO_REUSEADDR, (const char*)&opt, sizeof(opt));
+    if (cfg.reuse_port && 
+        !listener->setOpt(SOL_SOCKET, SO_REUSEPORT, 
+                          (const char*)&opt, sizeof(opt)))
+        throw std::runtime_error(
+            "tab::TcpServer::start(): Failed to enable SO_REUSEPORT.");
+
+    int fl = fcntl(listener->get(), F_GETFL, 0);
+    if (fl < 0 || fcntl(listener->get(), F_SETFL, fl | O_NONBLOCK) != 0)
+        throw std::runtime_error(
+            "tab::TcpServer::start(): "
+            "Failed to change the I/O mode of the server socket.");
+
+    if (!listener->bind(cfg.listen_address.getAddr()) || !listener->listen())
+        throw std::runtime_error(
+            "tab::TcpServer::start(): "
+            "Failed to listen on the configured address.");
+    return listener.release();
+}
+
+#endif // _LINUX
+
+
+void HandlerThread(TcpServer& s, size_t index) {
 #ifdef _WINDOWS
     DWORD byte_transferred = 0;
     ULONG_PTR completion_key;
@@ -94,8 +544,7 @@ void HandlerThread(TcpServer& s) {
             case ERROR_CONNECTION_ABORTED:
                 if (completion_key == 0)
                     break;
-                closesocket(((SocketContext*)completion_key)->socket);
-                delete (SocketContext*)completion_key;
+                CloseConnection((SocketContext*)completion_key);
                 continue;
             default:
                 break;
@@ -115,7 +564,7 @@ void HandlerThread(TcpServer& s) {
         
         // new connection accepted
         if (completion_key != 0 && socket_ctx->socket == s.socket_->get()) {
-            auto ctx_new = new SocketContext(s.event_matcher_);
+            auto ctx_new = new SocketContext(s.tcp_matcher_);
             ctx_new->socket = *(socket_t*)(void*)(socket_ctx->buffer);
             u_long param = 1;
             if (ioctlsocket(ctx_new->socket, FIONBIO, &param) != 0) {
@@ -131,7 +580,7 @@ void HandlerThread(TcpServer& s) {
                 continue;
             }
             ConnectionAcceptedEventInternal event(*socket_ctx, *ctx_new);
-            s.event_matcher_.call(event);
+            ConnectionAcceptedEventInternal::Handler(event);
 
             ctx_new->clearOverlapped();
             
@@ -142,8 +591,7 @@ void HandlerThread(TcpServer& s) {
         if (byte_transferred == 0) {
             if (completion_key == 0) // should exit
                 break;
-            closesocket(socket_ctx->socket);
-            delete socket_ctx;
+            CloseConnection(socket_ctx);
             continue;
         }
 
@@ -152,12 +600,12 @@ void HandlerThread(TcpServer& s) {
              == TcpServerEvent::OP_READ) { // read operation completed
             DataReceivedEventInternal event(*socket_ctx);
             //if (event.ctx_.buffer_add != nullptr)
-            if (event.ctx_.wsabuf.buf == event.ctx_.buffer_add)
+            if (event.ctx_.iobuf.buf == event.ctx_.buffer_add)
                 event.ctx_.content_length_add = byte_transferred;
             else
                 event.ctx_.content_length = byte_transferred;
 
-            s.event_matcher_.call(event);
+            DataReceivedEventInternal::Handler(event);
             
             socket_ctx->clearOverlapped();
             PostIORequest(socket_ctx);
@@ -165,7 +613,7 @@ void HandlerThread(TcpServer& s) {
         else { // write operation completed
             DataSentEventInternal event(*socket_ctx);
 
-            s.event_matcher_.call(event);
+            DataSentEventInternal::Handler(event);
 
             event.ctx_.clearOverlapped();
             PostIORequest(socket_ctx);
@@ -173,6 +621,29 @@ void HandlerThread(TcpServer& s) {
 
     }
 #endif // _WINDOWS
+#ifdef _LINUX
+    // With SO_REUSEPORT, every thread accepts on its own listener.
+    auto acceptor = (SocketContext*)s.acceptors_[
+        s.acceptors_.size() > 1 ? index : 0];
+    auto pool = (SocketContextPool*)s.pools_[index];
+    // OpenSSL writes the sockets by write(), and the segments of the 
+    // files are written by sendfile(2), neither of which takes 
+    // MSG_NOSIGNAL, so they raise SIGPIPE if the connection has been 
+    // reset by the peer.
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &set, nullptr);
+    if (s.use_uring_) {
+        if (UringHandlerThread(
+                acceptor, s.event_fd_, *pool, s.config_))
+            return;
+        // The ring can not be created in this thread, use epoll instead.
+    }
+    EpollHandlerThread(acceptor, s.event_fd_, *pool);
+#else
+    (void)index; // All threads wait on one completion port.
+#endif // _LINUX
 } // HandlerThread()
 
 
@@ -185,9 +656,9 @@ TcpServer& TcpServer::start() {
 
     checkConfig();
 
+#ifdef _WINDOWS
     socket_.reset(new ServerSocket(config_.listen_address.getAddr().getAF()));
 
-#ifdef _WINDOWS
     u_long param = 1;
     if (ioctlsocket(socket_->get(), FIONBIO, &param) != 0)
         throw std::runtime_error(
@@ -204,40 +675,72 @@ TcpServer& TcpServer::start() {
         throw std::runtime_error(
             "tab::TcpServer::start(): Failed to create a completion port.");
 #endif 
+#ifdef _LINUX
+    // The TLS connections are driven by OpenSSL, which does the I/O itself.
+    use_uring_ = config_.io_backend == TcpConfig::IOBackend::IO_URING && 
+                 !config_.tls_enable && UringAvailable();
+
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd_ < 0)
+        throw std::runtime_error(
+            "tab::TcpServer::start(): Failed to create an eventfd.");
+#endif // _LINUX
+#ifdef EN_OPENSSL
+    if (config_.tls_enable) {
+        SSL_CTX* ctx = configTLS().get();
+        tls_context_->setCertificateFile(
+            config_.tls_certificate_file.c_str());
+        tls_context_->setPrivateKeyFile(
+            config_.tls_private_key_file.c_str());
+        if (SSL_CTX_check_private_key(ctx) != 1)
+            throw std::runtime_error(
+                "tab::TcpServer::start(): "
+                "The private key does not match the certificate.");
+        // Written like send(), from where the last write stopped.
+        SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | 
+                              SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+        tls_context_->enableServerSessionCache();
+        alpn_wire_.clear();
+        for (auto& p : config_.tls_alpn_protocols) {
+            alpn_wire_.push_back(static_cast<char>(p.size()));
+            alpn_wire_.append(p);
+        }
+        if (!alpn_wire_.empty())
+            SSL_CTX_set_alpn_select_cb(ctx, SelectAlpn, &alpn_wire_);
+    }
+#endif // EN_OPENSSL
 
-    event_matcher_.set<ConnectionAcceptedEventInternal>(
-        ConnectionAcceptedEventInternal::Handler);
-    if (!event_matcher_.has<ConnectionAcceptedEvent>()) {
-        event_matcher_.set<ConnectionAcceptedEvent>(
+    // The internal events are handled by direct calls, 
+    // only the default handlers of the user events are set here.
+    if (!tcp_matcher_.has<ConnectionAcceptedEvent>()) {
+        tcp_matcher_.set<ConnectionAcceptedEvent>(
             [](ConnectionAcceptedEvent& e) {
                 std::memset(e.getBuffer(), 0, e.getBufferSize());
                 e.setNextOperation(TcpServerEvent::OP_READ);
             });
     }
-    event_matcher_.set<DataReceivedEventInternal>(
-        DataReceivedEventInternal::Handler);
-    if (!event_matcher_.has<DataReceivedEvent>()) {
-        event_matcher_.set<DataReceivedEvent>(
+    if (!tcp_matcher_.has<DataReceivedEvent>()) {
+        tcp_matcher_.set<DataReceivedEvent>(
             [](DataReceivedEvent& e) { 
                 e.setNextOperation(TcpServerEvent::OP_CLOSE);
             }
         );
     }
-    event_matcher_.set<DataSentEventInternal>(
-        DataSentEventInternal::Handler);
-    if (!event_matcher_.has<DataSentEvent>()) {
-        event_matcher_.set<DataSentEvent>(
+    if (!tcp_matcher_.has<DataSentEvent>()) {
+        tcp_matcher_.set<DataSentEvent>(
             [](DataSentEvent& e) { 
                 e.setNextOperation(TcpServerEvent::OP_CLOSE);
             }
         );
     }
+    if (!tcp_matcher_.has<ConnectionClosedEvent>())
+        tcp_matcher_.set<ConnectionClosedEvent>([](ConnectionClosedEvent&) { });
     
+#ifdef _WINDOWS
     socket_->bind(config_.listen_address);
     socket_->listen();
 
-#ifdef _WINDOWS
-    acceptor_ctx_ = new SocketContext(event_matcher_);
+    acceptor_ctx_ = new SocketContext(tcp_matcher_);
     ((SocketContext*)acceptor_ctx_)->socket = socket_->get();
     CreateIoCompletionPort(
         (HANDLE)socket_->get(), 
@@ -246,11 +749,37 @@ TcpServer& TcpServer::start() {
         0);
     PostAcceptRequest(socket_.get(), (SocketContext*)acceptor_ctx_);
 #endif // _WINDOWS
+#ifdef _LINUX
+    // One listener shared by all the handler threads, or one 
+    // for each of them if SO_REUSEPORT is required.
+    size_t listener_cnt = config_.reuse_port ? config_.concurrent_threads : 1;
+    for (size_t i = 0; i < listener_cnt; ++ i) {
+        listeners_.emplace_back(OpenListener(config_));
+        auto acceptor = new SocketContext(tcp_matcher_);
+        acceptor->socket = listeners_.back()->get();
+        acceptors_.push_back(acceptor);
+    }
+    for (size_t i = 0, max = config_.concurrent_threads; i < max; ++ i) {
+        auto pool = new SocketContextPool(
+            tcp_matcher_, 
+            config_.context_pool_prewarm, 
+            config_.context_pool_capacity);
+#ifdef EN_OPENSSL
+        if (config_.tls_enable)
+            pool->setTlsContext(tls_context_->get());
+#endif // EN_OPENSSL
+        int timeout = config_.connection_timeout_seconds;
+        pool->setTimeouts(TimeoutOf(config_.idle_timeout_seconds,  timeout),
+                          TimeoutOf(config_.read_timeout_seconds,  timeout),
+                          TimeoutOf(config_.write_timeout_seconds, timeout));
+        pools_.push_back(pool);
+    }
+#endif // _LINUX
     
     for (size_t i = 0, max = config_.concurrent_threads; i < max; ++ i)
         handlers_.emplace_back(
             std::unique_ptr<std::thread>(
-                new std::thread(HandlerThread, std::ref(*this))));
+                new std::thread(HandlerThread, std::ref(*this), i)));
     status_ = RUNNING;
     return *this;
 } // TcpServer::start()
@@ -265,83 +794,186 @@ TcpServer& TcpServer::stop() {
         PostQueuedCompletionStatus(completion_port_, 0, 0, nullptr);
     CloseHandle(completion_port_);
 #endif
-
-    socket_.reset();
+#ifdef _LINUX
+    eventfd_write(event_fd_, 1);
+#endif
 
     for (size_t i = 0; i < handlers_.size(); ++i) {
         if (handlers_[i]->joinable())
             handlers_[i]->join();
         handlers_[i].reset();
     }
+#ifdef _LINUX
+    _close(event_fd_);
+#endif
+
+#ifdef _WINDOWS
+    socket_.reset();
     delete (SocketContext*)acceptor_ctx_;
+#endif
+#ifdef _LINUX
+    for (auto acceptor : acceptors_)
+        delete (SocketContext*)acceptor;
+    acceptors_.clear();
+    listeners_.clear();
+    // The connections have been closed by the threads.
+    for (auto pool : pools_)
+        delete (SocketContextPool*)pool;
+    pools_.clear();
+#endif
     status_ = STOPPED;
     return *this;
 } // TcpServer::stop()
 
 
+TcpServer::ContextPoolStats TcpServer::getContextPoolStats() const {
+    ContextPoolStats ret;
+#ifdef _LINUX
+    for (auto pool : pools_) {
+        ret.hits   += ((const SocketContextPool*)pool)->hits();
+        ret.misses += ((const SocketContextPool*)pool)->misses();
+    }
+#endif // _LINUX
+    return ret;
+}
+
+
 template <class E>
 void TcpEventInternal::DumpEventData(E& des, SocketContext& ctx) {
-    des.buffer_           = ctx.buffer;
-    des.buffer_size_      = ctx.buffer_length;
-    des.buffer_add_       = ctx.buffer_add;
-    des.buffer_add_size_  = ctx.buffer_length_add;
-    des.content_size_     = ctx.content_length;
-    des.content_size_add_ = ctx.content_length_add;
-
-    if (ctx.wsabuf.buf == des.buffer_add_)
+    des.buffer_            = ctx.buffer;
+    des.buffer_size_       = ctx.buffer_length;
+    des.buffer_add_        = ctx.buffer_add;
+    des.buffer_add_size_   = ctx.buffer_length_add;
+    des.content_size_      = ctx.content_length;
+    des.content_size_add_  = ctx.content_length_add;
+    des.buffer_spare_      = ctx.buffer_spare;
+    des.buffer_spare_size_ = ctx.buffer_length_spare;
+
+    if (ctx.iobuf.buf == des.buffer_add_)
         des.active_buffer_ = TcpServerEventBase::EXTENDED;
     else
         des.active_buffer_ = TcpServerEventBase::DEFAULT;
 
+#if defined(_LINUX) && defined(EN_OPENSSL)
+    if (ctx.tls_state == SocketContext::TLS_ESTABLISHED) {
+        const unsigned char* alpn = nullptr;
+        unsigned int alpn_size = 0;
+        SSL_get0_alpn_selected(ctx.ssl, &alpn, &alpn_size);
+        if (alpn != nullptr) {
+            des.alpn_ = reinterpret_cast<const char*>(alpn);
+            des.alpn_size_ = alpn_size;
+        }
+    }
+#endif
+#ifdef _LINUX
+    des.timers_ = &ctx.pool->timers();
+#endif // _LINUX
+
     ctx.matcher_.call(des);
 
+    if (des.segments_ != nullptr && 
+        des.next_operation_ == TcpServerEventBase::OP_WRITE) {
+        size_t total = 0;
+        for (size_t i = 0; i < des.segment_count_; ++i)
+            total += des.segments_[i].size;
+#ifdef _LINUX
+        ctx.segments      = des.segments_;
+        ctx.segment_count = des.segment_count_;
+        ctx.segments_size = total;
+#else
+        // Gathered into the extended buffer, and written as usual.
+        auto len = static_cast<unsigned long>(total);
+        char* p = des.extendBuffer(len);
+        for (size_t i = 0; i < des.segment_count_; ++i) {
+            auto& seg = des.segments_[i];
+            if (seg.file == -1)
+                std::memcpy(p, seg.data, seg.size);
+            else
+                ReadFileSegment(seg, p);
+            p += seg.size;
+        }
+        des.setExtendedContentSize(len);
+        des.setActiveBuffer(TcpServerEventBase::EXTENDED);
+#endif // _LINUX
+    }
+#ifdef _LINUX
+    else {
+        ctx.segments      = nullptr;
+        ctx.segment_count = 0;
+        ctx.segments_size = 0;
+    }
+#endif // _LINUX
+
     // Additional buffer allocated
     if (des.allocated_buffer_add_) { 
         ctx.buffer_add = des.buffer_add_; 
         ctx.buffer_length_add = des.buffer_add_size_;
+        ctx.buffer_spare = des.buffer_spare_;
+        ctx.buffer_length_spare = des.buffer_spare_size_;
     }
     if (des.active_buffer_ == TcpServerEventBase::DEFAULT) {
-        ctx.wsabuf.buf = ctx.buffer;
+        ctx.iobuf.buf = ctx.buffer;
         if (des.next_operation_ == TcpServerEventBase::OP_WRITE)
-            ctx.wsabuf.len = des.content_size_;
+            ctx.iobuf.len = des.content_size_;
         else
-            ctx.wsabuf.len = des.buffer_size_;
+            ctx.iobuf.len = des.buffer_size_;
     } else {
-        ctx.wsabuf.buf = ctx.buffer_add;
+        ctx.iobuf.buf = ctx.buffer_add;
         if (des.next_operation_ == DataReceivedEvent::OP_WRITE)
-            ctx.wsabuf.len = des.content_size_add_;
+            ctx.iobuf.len = des.content_size_add_;
         else
-            ctx.wsabuf.len = des.buffer_add_size_;
+            ctx.iobuf.len = des.buffer_add_size_;
     }
     
     ctx.operation_required = des.next_operation_;
+
+#ifdef _LINUX
+    // A request being received keeps the deadline of its first data.
+    if (des.next_operation_ == TcpServerEvent::OP_WRITE)
+        ctx.pool->armDeadline(&ctx, SocketContext::WAIT_WRITE);
+    else if (des.next_operation_ != TcpServerEvent::OP_READ)
+        return;
+    else if (!std::is_same<E, DataReceivedEvent>::value)
+        ctx.pool->armDeadline(&ctx, SocketContext::WAIT_IDLE);
+    else if (ctx.wait_state != SocketContext::WAIT_READ)
+        ctx.pool->armDeadline(&ctx, SocketContext::WAIT_READ);
+#endif // _LINUX
 }
 
 
 void ConnectionAcceptedEventInternal::Handler(
     ConnectionAcceptedEventInternal& e) {
 
+#ifdef _WINDOWS
     PostAcceptRequest(
         *(ServerSocket**)(void*)(e.ctx_s.buffer + sizeof(socket_t)), &e.ctx_s);
+#endif // _WINDOWS
 
-    ConnectionAcceptedEvent event(e.ctx_c.flag);
+    ConnectionAcceptedEvent event(e.ctx_c.flag, e.ctx_c.user_data);
 
     TcpEventInternal::DumpEventData(event, e.ctx_c);
 
 }
 
 void DataReceivedEventInternal::Handler(DataReceivedEventInternal& e) {
-    DataReceivedEvent event(e.ctx_.flag);
+    DataReceivedEvent event(e.ctx_.flag, e.ctx_.user_data);
 
     TcpEventInternal::DumpEventData(event, e.ctx_);
 
 }  // DataReceivedEventInternal::Handler()
 
 void DataSentEventInternal::Handler(DataSentEventInternal& e) {
-    DataSentEvent event(e.ctx_.flag);
+    DataSentEvent event(e.ctx_.flag, e.ctx_.user_data);
     
     TcpEventInternal::DumpEventData(event, e.ctx_);
 
 }
 
+void ConnectionClosedEventInternal::Handler(ConnectionClosedEventInternal& e) {
+    ConnectionClosedEvent event(e.ctx_.flag, e.ctx_.user_data);
+
+    e.ctx_.matcher_.call(event);
+
+}
+
 } // namespace tab
\ No newline at end of file
@@ -1,63 +1,233 @@
 #ifndef __TCP_SERVER_EVENTS_INTERNAL__
 #define __TCP_SERVER_EVENTS_INTERNAL__
 
+#include <cstring>
 #include <functional>
 
+#ifdef _LINUX
+#  include <sys/socket.h>
+#  include <sys/uio.h>
+#endif // _LINUX
+
 #include "EzNet/Utility/Event/Event.hpp"
-#include "EzNet/Utility/Event/EventMatcher.hpp"
+#include "EzNet/Utility/Event/TimerWheel.hpp"
 #include "EzNet/Socket/StreamSocket.hpp"
+#include "EzNet/Socket/TcpServer.hpp"
 #include "EzNet/Socket/TcpServerEvents.hpp"
 
 namespace tab {
+#define LIMIT_DEFAULT_BUFFER 4096
+// Extended buffers larger than this are freed instead of being kept 
+// by a recycled 'SocketContext'.
+#define LIMIT_SPARE_BUFFER   65536
+
 #ifdef _WINDOWS
+using IOBuffer = WSABUF;
+#else
+// Same layout as 'WSABUF', so both platforms can share the code 
+// which describes the buffer of the next I/O operation.
+struct IOBuffer {
+    unsigned long len;
+    char*         buf;
+};
 
-#define LIMIT_DEFAULT_BUFFER 4096
+class SocketContextPool;
+#endif // _WINDOWS
 
 class SocketContext {
 public:
-    SocketContext(EventMatcher& e) : matcher_(e) {
-        wsabuf.buf = buffer;
-        wsabuf.len = buffer_length;
+    SocketContext(TcpServer::TcpEventMatcher& e) : matcher_(e) {
+        iobuf.buf = buffer;
+        iobuf.len = buffer_length;
+#ifdef _LINUX
+        // Wakes the operation in flight (or epoll) up with an error, so
+        // the connection is closed as usual, see 'SocketContextPool'.
+        deadline.callback = [this] { ::shutdown(socket, SHUT_RDWR); };
+#endif // _LINUX
     }
 
     ~SocketContext() {
+#ifdef _LINUX
+        closePipe();
+#endif // _LINUX
         if (buffer_add != nullptr)
             delete[] buffer_add;
+        if (buffer_spare != nullptr)
+            delete[] buffer_spare;
+    }
+
+    /**
+     * Reset the state for a new connection. The extended buffer is kept 
+     * as the spare one if it is not too large, and 'extendBuffer()' of 
+     * the next connection takes it instead of allocating a new one.
+     */
+    void recycle() {
+        if (buffer_add != nullptr) {
+            if (buffer_length_add <= LIMIT_SPARE_BUFFER && 
+                buffer_length_add > buffer_length_spare) {
+                if (buffer_spare != nullptr)
+                    delete[] buffer_spare;
+                buffer_spare        = buffer_add;
+                buffer_length_spare = buffer_length_add;
+            }
+            else {
+                delete[] buffer_add;
+            }
+        }
+        buffer_add         = nullptr;
+        buffer_length_add  = 0;
+        content_length     = 0;
+        content_length_add = 0;
+        iobuf.buf          = buffer;
+        iobuf.len          = buffer_length;
+#ifdef _LINUX
+        transferred        = 0;
+        segments           = nullptr;
+        segment_count      = 0;
+        segments_size      = 0;
+        // The data left in the pipe belong to the closed connection.
+        if (piped > 0)
+            closePipe();
+#endif // _LINUX
+        flag               = 0;
+        user_data          = nullptr;
+    }
+
+#ifdef _LINUX
+    /**
+     * The first segment which is not written completely, and how many 
+     * bytes of it have been written ('done'), or null if there is none.
+     */
+    const OutputSegment* pendingSegment(size_t& done) const {
+        size_t skip = transferred;
+        for (size_t i = 0; i < segment_count; ++i) {
+            if (skip < segments[i].size) {
+                done = skip;
+                return segments + i;
+            }
+            skip -= segments[i].size;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Fill 'iov' with at most 'max' segments which are not written yet, 
+     * stopping at the first segment of a file. 'file_next' tells whether
+     * it is where they stop.
+     */
+    size_t pendingSegments(iovec* iov, size_t max, 
+                           bool* file_next = nullptr) const {
+        size_t skip = transferred, n = 0;
+        if (file_next != nullptr)
+            *file_next = false;
+        for (size_t i = 0; i < segment_count && n < max; ++i) {
+            if (skip >= segments[i].size) {
+                skip -= segments[i].size;
+                continue;
+            }
+            if (segments[i].file != -1) {
+                if (file_next != nullptr)
+                    *file_next = true;
+                break;
+            }
+            iov[n].iov_base = const_cast<char*>(segments[i].data) + skip;
+            iov[n].iov_len  = segments[i].size - skip;
+            skip = 0;
+            ++n;
+        }
+        return n;
+    }
+
+    void closePipe() {
+        if (pipe_fds[0] != -1) {
+            ::close(pipe_fds[0]);
+            ::close(pipe_fds[1]);
+        }
+        pipe_fds[0] = pipe_fds[1] = -1;
+        piped = 0;
     }
+#endif // _LINUX
 
     void clearBuffer() {
         std::memset(buffer, 0, buffer_length);
     }
+#ifdef _WINDOWS
     void clearOverlapped() {
         std::memset(&overlapped, 0, sizeof(OVERLAPPED));
     }
+#endif // _WINDOWS
     void allocateAdditionalBuffer(unsigned long size) {
         buffer_add = new char[size];
         buffer_length = size;
     }
 
+#ifdef _WINDOWS
     OVERLAPPED overlapped;
+#endif // _WINDOWS
     socket_t   socket;
     TcpServerEvent::OPERATION operation_required; // 1: read  0: write
 
-    char       buffer[LIMIT_DEFAULT_BUFFER];
-    ULONG      buffer_length = LIMIT_DEFAULT_BUFFER;
-    ULONG      content_length = 0;
+    char          buffer[LIMIT_DEFAULT_BUFFER];
+    unsigned long buffer_length = LIMIT_DEFAULT_BUFFER;
+    unsigned long content_length = 0;
     // enable when 'buffer' is full but the data is not completely transferred
-    char*      buffer_add = nullptr;
-    ULONG      buffer_length_add = 0;
-    ULONG      content_length_add = 0;
+    char*         buffer_add = nullptr;
+    unsigned long buffer_length_add = 0;
+    unsigned long content_length_add = 0;
+    // the extended buffer kept from a previous connection
+    char*         buffer_spare = nullptr;
+    unsigned long buffer_length_spare = 0;
     // Integrate this variable into the socket context 
     // can lessen assignment operations.
-    WSABUF     wsabuf; 
+    IOBuffer      iobuf; 
+#ifdef _LINUX
+    // Bytes of 'iobuf' (or the segments) which have been sent by the 
+    // previous non-blocking writes. A write operation completes when it 
+    // reaches 'iobuf.len' (or 'segments_size').
+    unsigned long transferred = 0;
+    // Written instead of 'iobuf' if it is not null, 
+    // see 'TcpServerEventBase::setOutputSegments()'.
+    const OutputSegment* segments = nullptr;
+    size_t        segment_count = 0;
+    size_t        segments_size = 0;
+    // io_uring only, the message of the SENDMSG request in flight.
+    msghdr        msg;
+    iovec         msg_iov[8];
+    // io_uring only, the pipe through which the segments of the files are
+    // spliced to the socket, created by the first of them, and the bytes 
+    // in it which are not written yet.
+    int           pipe_fds[2] = { -1, -1 };
+    size_t        piped = 0;
+    // The pool which owns this context, see 'SocketContextPool'.
+    SocketContextPool* pool = nullptr;
+    // Links of the pool's list of the contexts in use.
+    SocketContext* prev = nullptr;
+    SocketContext* next = nullptr;
+    // What the connection is waiting for, whose deadline is armed in the
+    // timers of the pool.
+    enum WaitState : unsigned char {
+        WAIT_NONE, WAIT_IDLE, WAIT_READ, WAIT_WRITE
+    };
+    WaitState     wait_state = WAIT_NONE;
+    TimerWheel::Timer deadline;
+#ifdef EN_OPENSSL
+    enum TlsState : unsigned char { 
+        TLS_NONE, TLS_HANDSHAKE, TLS_ESTABLISHED, TLS_FAILED 
+    };
+    // The TLS session of the connection, kept by the pool with the 
+    // context, and cleared for the next connection.
+    SSL*          ssl = nullptr;
+    TlsState      tls_state = TLS_NONE;
+#endif // EN_OPENSSL
+#endif // _LINUX
     // Reserved flag for higher level applications
-    unsigned long long flag;
+    unsigned long long flag = 0;
+    // Reserved pointer for higher level applications
+    void*         user_data = nullptr;
 
-    EventMatcher& matcher_;
+    TcpServer::TcpEventMatcher& matcher_;
 };
 
-#endif // _WINDOWS
-
 class TcpEventInternal : public Event {
 public:
     constexpr static event_type_id_t GetEventTypeID() {
@@ -122,6 +292,35 @@ public:
 }; // class DataSentEventInternal
 
 
+class ConnectionClosedEventInternal : public TcpEventInternal {
+public:
+    constexpr static event_type_id_t GetEventTypeID() {
+        return TcpEventInternal::GetEventTypeID() + 4;
+    }
+
+    // Implemented in 'TcpServer.cpp'
+    static void Handler(ConnectionClosedEventInternal&);
+
+public:
+    ConnectionClosedEventInternal(SocketContext& x) : ctx_(x) { }
+
+    SocketContext& ctx_;
+}; // class ConnectionClosedEventInternal
+
+
+#ifdef _LINUX
+
+// Implemented in 'TcpServerUring.cpp'.
+// Returns false if the ring can not be created in the calling thread.
+bool UringHandlerThread(SocketContext* acceptor, int stop_fd,
+                        SocketContextPool& pool,
+                        const TcpServer::TcpConfig& cfg);
+
+// Implemented in 'TcpServerUring.cpp'.
+bool UringAvailable();
+
+#endif // _LINUX
+
 } // namespace tab
 
 #endif // __TCP_SERVER_EVENTS_INTERNAL__
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <vector>
+
+#include "EzNet/Socket/TcpServer.hpp"
+#include "TcpServerEventsInternal.hpp"
+#include "IoUring.hpp"
+#include "SocketContextPool.hpp"
+
+#ifdef _LINUX
+
+#include <fcntl.h>
+#include <poll.h>
+
+namespace tab {
+
+namespace {
+
+// 'user_data' of the request watching the stopping eventfd.
+const __u64 STOP_TAG = 0;
+// 'user_data' of the requests waking the loop up for the timers, which 
+// is never the address of a context.
+const __u64 TIMEOUT_TAG = 1;
+
+// Bytes of a file spliced into the pipe at a time, which fit in an empty
+// pipe of the default size, so the splice never blocks.
+const size_t PIPE_CHUNK = 65536;
+
+/**
+ * The completion-based event loop of one handler thread.
+ *
+ * It works like the IOCP path: every connection has at most one request
+ * in flight, and the completion of it dispatches the corresponding event
+ * and posts the next request. New requests are only queued while handling
+ * completions, and they are submitted together with waiting for the next
+ * completions in one io_uring_enter(2).
+ */
+class UringReactor {
+public:
+    UringReactor(SocketContext* acceptor, int stop_fd,
+                 SocketContextPool& pool,
+                 const TcpServer::TcpConfig& cfg) :
+        acceptor_(acceptor),
+        stop_fd_(stop_fd),
+        pool_(pool),
+        queue_depth_(cfg.uring_queue_depth) { }
+
+    bool init() {
+        if (!ring_.init(queue_depth_))
+            return false;
+        // The pre-warmed contexts are in one mapping, register it as a 
+        // whole, so that every 'SocketContext::buffer' inside can be read 
+        // by READ_FIXED without mapping the user pages for each request.
+        iovec slab = pool_.slab();
+        if (slab.iov_len > 0)
+            fixed_buffers_ = ring_.registerBuffers(&slab, 1);
+        return true;
+    }
+
+    void run() {
+        postAccept();
+        postStopWatcher();
+        while (running_) {
+            postTimeout();
+            if (ring_.submit(1) < 0 && errno != EBUSY && errno != EAGAIN) {
+                std::cerr
+                    << "tab::UringReactor::run(): io_uring_enter() failed, "
+                    "error: " << errno << "." << std::endl;
+                break;
+            }
+            ring_.forEachCqe([this](const io_uring_cqe& cqe) {
+                onCompletion(cqe);
+            });
+            // The connections expired are shut down, which completes 
+            // their requests in flight.
+            pool_.timers().advance();
+        }
+    }
+
+private:
+    void postAccept() {
+        io_uring_sqe* sqe = ring_.getSqe();
+        if (sqe == nullptr)
+            return;
+        sqe->opcode       = IORING_OP_ACCEPT;
+        sqe->fd           = acceptor_->socket;
+        sqe->accept_flags = SOCK_CLOEXEC;
+        if (multishot_accept_)
+            sqe->ioprio  |= IORING_ACCEPT_MULTISHOT;
+        sqe->user_data    = reinterpret_cast<__u64>(acceptor_);
+    }
+
+    void postStopWatcher() {
+        io_uring_sqe* sqe = ring_.getSqe();
+        if (sqe == nullptr)
+            return;
+        sqe->opcode        = IORING_OP_POLL_ADD;
+        sqe->fd            = stop_fd_;
+        sqe->poll32_events = POLLIN;
+        sqe->user_data     = STOP_TAG;
+    }
+
+    /**
+     * Post a TIMEOUT request for the next timer, unless one which expires
+     * no later is pending. The pending ones expire in the reverse order 
+     * of being posted, since a new one is only posted for an earlier time.
+     */
+    void postTimeout() {
+        int ms = pool_.timers().nextTimeout();
+        if (ms < 0)
+            return;
+        auto at = TimerWheel::Clock::now() + std::chrono::milliseconds(ms);
+        if (!timeouts_.empty() && timeouts_.back() <= at)
+            return;
+        io_uring_sqe* sqe = ring_.getSqe();
+        if (sqe == nullptr)
+            return;
+        // Read when the request is submitted, which is before the next one
+        // is prepared.
+        timeout_spec_.tv_sec  = ms / 1000;
+        timeout_spec_.tv_nsec = static_cast<long long>(ms % 1000) * 1000000;
+        sqe->opcode    = IORING_OP_TIMEOUT;
+        sqe->fd        = -1;
+        sqe->addr      = reinterpret_cast<__u64>(&timeout_spec_);
+        sqe->len       = 1;
+        sqe->off       = 0; // not counting the completions
+        sqe->user_data = TIMEOUT_TAG;
+        timeouts_.push_back(at);
+    }
+
+    void postIORequest(SocketContext* ctx) {
+        if (ctx->operation_required != TcpServerEvent::OP_READ &&
+            ctx->operation_required != TcpServerEvent::OP_WRITE) {
+            closeConnection(ctx);
+            return;
+        }
+        if (ctx->operation_required == TcpServerEvent::OP_WRITE && 
+            !fillPipe(ctx)) {
+            closeConnection(ctx);
+            return;
+        }
+        io_uring_sqe* sqe = ring_.getSqe();
+        if (sqe == nullptr) {
+            std::cerr << "tab::UringReactor::postIORequest(): "
+                         "Submission queue is full." << std::endl;
+            closeConnection(ctx);
+            return;
+        }
+        sqe->fd        = ctx->socket;
+        sqe->user_data = reinterpret_cast<__u64>(ctx);
+        if (ctx->operation_required == TcpServerEvent::OP_READ) {
+            sqe->addr = reinterpret_cast<__u64>(ctx->iobuf.buf);
+            sqe->len  = static_cast<__u32>(ctx->iobuf.len);
+            if (fixed_buffers_ && pool_.inSlab(ctx->iobuf.buf)) {
+                sqe->opcode    = IORING_OP_READ_FIXED;
+                sqe->buf_index = 0;
+            }
+            else {
+                sqe->opcode    = IORING_OP_RECV;
+            }
+        }
+        else if (ctx->piped > 0) {
+            // The part of a file in the pipe, see 'fillPipe()'. The 
+            // offsets of pipes must be -1.
+            sqe->opcode        = IORING_OP_SPLICE;
+            sqe->splice_fd_in  = ctx->pipe_fds[0];
+            sqe->splice_off_in = static_cast<__u64>(-1);
+            sqe->off           = static_cast<__u64>(-1);
+            sqe->len           = static_cast<__u32>(ctx->piped);
+            sqe->splice_flags  = SPLICE_F_MOVE;
+        }
+        else if (ctx->segments != nullptr) {
+            // Gathered by SENDMSG, whose message must stay valid until 
+            // the completion, so it is kept in the context.
+            bool file_next = false;
+            ctx->msg = msghdr{};
+            ctx->msg.msg_iov    = ctx->msg_iov;
+            ctx->msg.msg_iovlen = ctx->pendingSegments(
+                ctx->msg_iov, sizeof(ctx->msg_iov) / sizeof(iovec), 
+                &file_next);
+            sqe->opcode    = IORING_OP_SENDMSG;
+            sqe->addr      = reinterpret_cast<__u64>(&ctx->msg);
+            sqe->len       = 1;
+            // The last partial packet waits for the file following.
+            sqe->msg_flags = MSG_NOSIGNAL | (file_next ? MSG_MORE : 0);
+        }
+        else {
+            // A plain write(2) on a socket raises SIGPIPE when the peer
+            // has gone, so use send(2) with MSG_NOSIGNAL here.
+            sqe->opcode    = IORING_OP_SEND;
+            sqe->addr      = reinterpret_cast<__u64>(
+                                 ctx->iobuf.buf + ctx->transferred);
+            sqe->len       = static_cast<__u32>(
+                                 ctx->iobuf.len - ctx->transferred);
+            sqe->msg_flags = MSG_NOSIGNAL;
+        }
+    }
+
+    /**
+     * If the next segment to write is of a file and the pipe is empty, 
+     * splice the next part of the file into the pipe, which only takes 
+     * the references of its pages in the page cache. The ring splices it
+     * from the pipe to the socket then. Returns false if it fails, or the
+     * file is shorter than the segment.
+     */
+    bool fillPipe(SocketContext* ctx) {
+        if (ctx->segments == nullptr || ctx->piped > 0)
+            return true;
+        size_t done = 0;
+        const OutputSegment* seg = ctx->pendingSegment(done);
+        if (seg == nullptr || seg->file == -1)
+            return true;
+        if (ctx->pipe_fds[0] == -1 && pipe2(ctx->pipe_fds, O_CLOEXEC) != 0) {
+            ctx->pipe_fds[0] = ctx->pipe_fds[1] = -1;
+            return false;
+        }
+        loff_t offset = static_cast<loff_t>(seg->offset + done);
+        ssize_t n = splice(seg->file, &offset, ctx->pipe_fds[1], nullptr, 
+                           std::min(seg->size - done, PIPE_CHUNK), 
+                           SPLICE_F_MOVE);
+        if (n <= 0)
+            return false;
+        ctx->piped = static_cast<size_t>(n);
+        return true;
+    }
+
+    void closeConnection(SocketContext* ctx) {
+        pool_.close(ctx);
+    }
+
+    void onCompletion(const io_uring_cqe& cqe) {
+        if (cqe.user_data == STOP_TAG) {
+            running_ = false;
+            return;
+        }
+        if (cqe.user_data == TIMEOUT_TAG) {
+            timeouts_.pop_back();
+            return;
+        }
+        auto ctx = reinterpret_cast<SocketContext*>(cqe.user_data);
+        if (ctx == acceptor_) {
+            onAccepted(cqe);
+            return;
+        }
+
+        if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+            postIORequest(ctx);
+            return;
+        }
+        if (ctx->operation_required == TcpServerEvent::OP_READ) {
+            if (cqe.res <= 0) { // peer closed or error occurred
+                closeConnection(ctx);
+                return;
+            }
+            DataReceivedEventInternal event(*ctx);
+            if (ctx->iobuf.buf == ctx->buffer_add)
+                ctx->content_length_add = static_cast<unsigned long>(cqe.res);
+            else
+                ctx->content_length = static_cast<unsigned long>(cqe.res);
+            DataReceivedEventInternal::Handler(event);
+        }
+        else {
+            // Nothing spliced from the pipe means the socket is closed.
+            if (cqe.res < 0 || (cqe.res == 0 && ctx->piped > 0)) {
+                closeConnection(ctx);
+                return;
+            }
+            if (ctx->piped > 0)
+                ctx->piped -= static_cast<size_t>(cqe.res);
+            ctx->transferred += static_cast<unsigned long>(cqe.res);
+            unsigned long total = ctx->segments != nullptr ? 
+                ctx->segments_size : ctx->iobuf.len;
+            if (ctx->transferred < total) { // partially sent
+                if (cqe.res > 0)
+                    pool_.armDeadline(ctx, SocketContext::WAIT_WRITE);
+                postIORequest(ctx);
+                return;
+            }
+            ctx->transferred = 0;
+            DataSentEventInternal event(*ctx);
+            DataSentEventInternal::Handler(event);
+        }
+        postIORequest(ctx);
+    }
+
+    void onAccepted(const io_uring_cqe& cqe) {
+        if (cqe.res >= 0) {
+            SocketContext* ctx_new = pool_.acquire();
+            ctx_new->socket = cqe.res;
+
+            ConnectionAcceptedEventInternal event(*acceptor_, *ctx_new);
+            ConnectionAcceptedEventInternal::Handler(event);
+
+            postIORequest(ctx_new);
+        }
+        else if (cqe.res == -EINVAL && multishot_accept_) {
+            // Multishot accept requires Linux 5.19, use one-shot requests.
+            multishot_accept_ = false;
+        }
+        else if (cqe.res != -EAGAIN && cqe.res != -EINTR &&
+                 cqe.res != -ECONNABORTED) {
+            std::cerr
+                << "tab::UringReactor::onAccepted(): accept failed, error: "
+                << -cqe.res << "." << std::endl;
+            if (cqe.res == -EBADF || cqe.res == -EINVAL ||
+                cqe.res == -ENOTSOCK)
+                return; // the server socket is unusable, stop accepting
+        }
+        if (!(cqe.flags & IORING_CQE_F_MORE))
+            postAccept();
+    }
+
+    SocketContext* acceptor_;
+    int            stop_fd_;
+    // Outlives the ring, so the registered buffers are unmapped 
+    // after the ring is closed.
+    SocketContextPool& pool_;
+    IoUring        ring_;
+    unsigned       queue_depth_;
+    bool           fixed_buffers_    = false;
+    bool           multishot_accept_ = true;
+    bool           running_          = true;
+    // The times of the pending TIMEOUT requests, the earliest last.
+    std::vector<TimerWheel::Clock::time_point> timeouts_;
+    __kernel_timespec timeout_spec_{};
+
+}; // class UringReactor
+
+} // namespace
+
+
+bool UringHandlerThread(SocketContext* acceptor, int stop_fd,
+                        SocketContextPool& pool,
+                        const TcpServer::TcpConfig& cfg) {
+    {
+        UringReactor reactor(acceptor, stop_fd, pool, cfg);
+        if (!reactor.init())
+            return false;
+        reactor.run();
+    }
+    // After the ring is gone, so the requests in flight no longer use
+    // the buffers of the connections.
+    pool.closeAll();
+    return true;
+}
+
+
+bool UringAvailable() {
+    IoUring probe;
+    return probe.init(2);
+}
+
+} // namespace tab
+
+#endif // _LINUX
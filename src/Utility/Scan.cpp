@@ -0,0 +1,248 @@
+#include <atomic>
+
+#include "EzNet/Basic/platform.h"
+#include "EzNet/Utility/General/Scan.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    (defined(__i386__) && defined(__SSE2__))
+#  define SCAN_SSE2
+#  include <emmintrin.h>
+#  if defined(_GCC)
+// Compiled for AVX2 with the 'target' attribute, and used only if the CPU
+// supports it, so the rest of the library needs no special flags.
+#    define SCAN_AVX2
+#    include <immintrin.h>
+#  endif // _GCC
+#  ifdef _MSVC
+#    include <intrin.h>
+#  endif // _MSVC
+#endif
+
+namespace tab {
+
+namespace {
+
+using Find1 = const char* (*)(const char*, const char*, char);
+using Find2 = const char* (*)(const char*, const char*, char, char);
+
+const char* Find1Scalar(const char* p, const char* end, char c) {
+    for (; p < end; ++p)
+        if (*p == c)
+            return p;
+    return end;
+}
+
+const char* Find2Scalar(const char* p, const char* end, char a, char b) {
+    for (; p < end; ++p)
+        if (*p == a || *p == b)
+            return p;
+    return end;
+}
+
+#ifdef SCAN_SSE2
+
+inline unsigned FirstBit(unsigned mask) {
+#ifdef _MSVC
+    unsigned long ret;
+    _BitScanForward(&ret, mask);
+    return static_cast<unsigned>(ret);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+const char* Find1Sse2(const char* p, const char* end, char c) {
+    const __m128i n = _mm_set1_epi8(c);
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned m = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(v, n)));
+        if (m != 0)
+            return p + FirstBit(m);
+    }
+    return Find1Scalar(p, end, c);
+}
+
+const char* Find2Sse2(const char* p, const char* end, char a, char b) {
+    const __m128i na = _mm_set1_epi8(a);
+    const __m128i nb = _mm_set1_epi8(b);
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(v, na),
+                                  _mm_cmpeq_epi8(v, nb));
+        unsigned m = static_cast<unsigned>(_mm_movemask_epi8(eq));
+        if (m != 0)
+            return p + FirstBit(m);
+    }
+    return Find2Scalar(p, end, a, b);
+}
+
+#endif // SCAN_SSE2
+
+#ifdef SCAN_AVX2
+
+__attribute__((target("avx2")))
+const char* Find1Avx2(const char* p, const char* end, char c) {
+    const __m256i n = _mm256_set1_epi8(c);
+    for (; end - p >= 64; p += 64) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i v1 = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(p + 32));
+        unsigned m0 = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(v0, n)));
+        unsigned m1 = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, n)));
+        if ((m0 | m1) != 0)
+            return m0 != 0 ? p + FirstBit(m0) : p + 32 + FirstBit(m1);
+    }
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned m = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, n)));
+        if (m != 0)
+            return p + FirstBit(m);
+    }
+    return Find1Sse2(p, end, c);
+}
+
+__attribute__((target("avx2")))
+const char* Find2Avx2(const char* p, const char* end, char a, char b) {
+    const __m256i na = _mm256_set1_epi8(a);
+    const __m256i nb = _mm256_set1_epi8(b);
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i eq = _mm256_or_si256(_mm256_cmpeq_epi8(v, na),
+                                     _mm256_cmpeq_epi8(v, nb));
+        unsigned m = static_cast<unsigned>(_mm256_movemask_epi8(eq));
+        if (m != 0)
+            return p + FirstBit(m);
+    }
+    return Find2Sse2(p, end, a, b);
+}
+
+#endif // SCAN_AVX2
+
+bool Supports(ScanKernel k) {
+    switch (k) {
+    case ScanKernel::SCALAR:
+        return true;
+#ifdef SCAN_SSE2
+    case ScanKernel::SSE2:
+        return true;
+#endif // SCAN_SSE2
+#ifdef SCAN_AVX2
+    case ScanKernel::AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif // SCAN_AVX2
+    default:
+        return false;
+    }
+}
+
+ScanKernel BestKernel() {
+    if (Supports(ScanKernel::AVX2))
+        return ScanKernel::AVX2;
+    if (Supports(ScanKernel::SSE2))
+        return ScanKernel::SSE2;
+    return ScanKernel::SCALAR;
+}
+
+const char* Find1Resolve(const char*, const char*, char);
+const char* Find2Resolve(const char*, const char*, char, char);
+
+// Both start with the resolvers, which choose the implementation when
+// scanning the first time, so they are usable during static
+// initialization and cost nothing more later. Threads may resolve them
+// concurrently, and they all store the same values.
+std::atomic<Find1>      find1{Find1Resolve};
+std::atomic<Find2>      find2{Find2Resolve};
+std::atomic<ScanKernel> kernel{ScanKernel::SCALAR};
+
+void Use(ScanKernel k) {
+    Find1 f1 = Find1Scalar;
+    Find2 f2 = Find2Scalar;
+    switch (k) {
+#ifdef SCAN_AVX2
+    case ScanKernel::AVX2:
+        f1 = Find1Avx2;
+        f2 = Find2Avx2;
+        break;
+#endif // SCAN_AVX2
+#ifdef SCAN_SSE2
+    case ScanKernel::SSE2:
+        f1 = Find1Sse2;
+        f2 = Find2Sse2;
+        break;
+#endif // SCAN_SSE2
+    default:
+        break;
+    }
+    kernel.store(k, std::memory_order_relaxed);
+    find1.store(f1, std::memory_order_relaxed);
+    find2.store(f2, std::memory_order_relaxed);
+}
+
+const char* Find1Resolve(const char* p, const char* end, char c) {
+    Use(BestKernel());
+    return find1.load(std::memory_order_relaxed)(p, end, c);
+}
+
+const char* Find2Resolve(const char* p, const char* end, char a, char b) {
+    Use(BestKernel());
+    return find2.load(std::memory_order_relaxed)(p, end, a, b);
+}
+
+} // namespace
+
+
+const char* ScanForLong(const char* begin, const char* end, 
+                        char c) noexcept {
+    return find1.load(std::memory_order_relaxed)(begin, end, c);
+}
+
+
+const char* ScanForLong(const char* begin, const char* end,
+                        char a, char b) noexcept {
+    return find2.load(std::memory_order_relaxed)(begin, end, a, b);
+}
+
+
+size_t FindHeadEnd(const char* p, size_t len, size_t& from) noexcept {
+    const char* end = p + len;
+    const char* q = p + from;
+    for (;;) {
+        const char* nl = ScanFor(q, end, '\n');
+        if (nl == end) {
+            from = len;
+            return 0;
+        }
+        size_t left = static_cast<size_t>(end - nl) - 1;
+        if (left >= 1 && nl[1] == '\n')
+            return static_cast<size_t>(nl - p) + 2;
+        if (left >= 2 && nl[1] == '\r' && nl[2] == '\n')
+            return static_cast<size_t>(nl - p) + 3;
+        if (left == 0 || (left == 1 && nl[1] == '\r')) {
+            from = static_cast<size_t>(nl - p);
+            return 0;
+        }
+        q = nl + 1;
+    }
+}
+
+
+ScanKernel GetScanKernel() noexcept {
+    if (find1.load(std::memory_order_relaxed) == Find1Resolve)
+        Use(BestKernel());
+    return kernel.load(std::memory_order_relaxed);
+}
+
+
+bool SetScanKernel(ScanKernel k) noexcept {
+    if (!Supports(k))
+        return false;
+    Use(k);
+    return true;
+}
+
+} // namespace tab
@@ -0,0 +1,215 @@
+#include <climits>
+
+#include "EzNet/Basic/platform.h"
+#include "EzNet/Utility/Event/TimerWheel.hpp"
+
+#ifdef _MSVC
+#  include <intrin.h>
+#endif // _MSVC
+
+namespace tab {
+
+namespace {
+
+constexpr unsigned long long SLOT_MASK = TimerWheel::SLOTS - 1;
+
+// Index of the lowest bit set, 'x' must not be 0.
+unsigned LowestBit(uint64_t x) {
+#ifdef _MSVC
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<unsigned>(i);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif // _MSVC
+}
+
+// Bit 'i' of the result is bit ('i' + 'n') % 64 of 'x'.
+uint64_t RotateRight(uint64_t x, unsigned n) {
+    n &= 63;
+    return n == 0 ? x : (x >> n) | (x << (64 - n));
+}
+
+} // namespace
+
+void TimerWheel::Timer::cancel() noexcept {
+    if (wheel_ == nullptr)
+        return;
+    wheel_->unlink(*this);
+    --wheel_->count_;
+    wheel_ = nullptr;
+}
+
+TimerWheel::TimerWheel() : start_(Clock::now()) {
+    for (auto& head : slots_)
+        head.prev = head.next = &head;
+}
+
+TimerWheel::~TimerWheel() {
+    for (auto& head : slots_) {
+        for (Link* p = head.next; p != &head;) {
+            auto& timer = static_cast<Timer&>(*p);
+            p = p->next;
+            timer.prev = timer.next = nullptr;
+            timer.wheel_ = nullptr;
+        }
+    }
+}
+
+void TimerWheel::arm(Timer& timer, unsigned long long milliseconds) {
+    timer.cancel();
+    if (milliseconds > NEVER / 2)
+        milliseconds = NEVER / 2;
+    unsigned long long expires = tickOf(Clock::now()) + milliseconds;
+    if (expires <= now_)
+        expires = now_ + 1;
+    timer.expires_ = expires;
+    timer.wheel_   = this;
+    ++count_;
+    link(timer);
+}
+
+size_t TimerWheel::advance(Clock::time_point now) {
+    unsigned long long target = tickOf(now);
+    size_t expired = 0;
+    while (count_ > 0) {
+        unsigned long long tick = nextTick();
+        if (tick > target)
+            break;
+        now_ = tick;
+        // The higher levels first, since their timers may be due now.
+        for (unsigned level = LEVELS - 1; level > 0; --level) {
+            unsigned shift = SLOT_BITS * level;
+            if ((tick & ((1ULL << shift) - 1)) != 0)
+                continue;
+            unsigned index = static_cast<unsigned>((tick >> shift) & SLOT_MASK);
+            if (occupied_[level] >> index & 1)
+                cascade(level, index);
+        }
+        expired += expire(static_cast<unsigned>(tick & SLOT_MASK));
+    }
+    if (target > now_)
+        now_ = target;
+    return expired;
+}
+
+int TimerWheel::nextTimeout() const {
+    if (count_ == 0)
+        return -1;
+    unsigned long long tick = nextTick();
+    unsigned long long current = tickOf(Clock::now());
+    if (tick <= current)
+        return 0;
+    return tick - current > INT_MAX ? INT_MAX
+                                    : static_cast<int>(tick - current);
+}
+
+unsigned long long TimerWheel::tickOf(Clock::time_point t) const {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        t - start_).count();
+    return ms > 0 ? static_cast<unsigned long long>(ms) : 0;
+}
+
+void TimerWheel::link(Timer& timer) {
+    unsigned level = 0;
+    unsigned long long index;
+    if (timer.expires_ <= now_) {
+        // Due at the tick being advanced to, whose slot of level 0 is
+        // expired after the cascading.
+        index = now_ & SLOT_MASK;
+    }
+    else {
+        // The level is the highest group of bits where the expiry differs
+        // from now, so the slot is reached before (or when) it expires.
+        unsigned long long diff = timer.expires_ ^ now_;
+        while (level + 1 < LEVELS && (diff >> (SLOT_BITS * (level + 1))) != 0)
+            ++level;
+        unsigned shift = SLOT_BITS * level;
+        unsigned long long unit = timer.expires_ >> shift;
+        // Further than the top level, wait in the furthest slot which
+        // does not pass the expiry.
+        if ((diff >> (shift + SLOT_BITS)) != 0 &&
+            unit > (now_ >> shift) + SLOT_MASK)
+            unit = (now_ >> shift) + SLOT_MASK;
+        index = unit & SLOT_MASK;
+    }
+    timer.slot_ = static_cast<unsigned>(level * SLOTS + index);
+    Link& head = slots_[timer.slot_];
+    timer.prev = head.prev;
+    timer.next = &head;
+    head.prev->next = &timer;
+    head.prev = &timer;
+    occupied_[level] |= 1ULL << index;
+}
+
+void TimerWheel::unlink(Timer& timer) noexcept {
+    timer.prev->next = timer.next;
+    timer.next->prev = timer.prev;
+    timer.prev = timer.next = nullptr;
+    Link& head = slots_[timer.slot_];
+    if (head.next == &head)
+        occupied_[timer.slot_ / SLOTS] &= ~(1ULL << (timer.slot_ % SLOTS));
+}
+
+unsigned long long TimerWheel::nextTick() const noexcept {
+    unsigned long long ret = NEVER;
+    for (unsigned level = 0; level < LEVELS; ++level) {
+        if (occupied_[level] == 0)
+            continue;
+        // The first slot having timers from the next one of this level.
+        unsigned shift = SLOT_BITS * level;
+        unsigned long long unit = (now_ >> shift) + 1;
+        unit += LowestBit(RotateRight(occupied_[level],
+                                      static_cast<unsigned>(unit & SLOT_MASK)));
+        if ((unit << shift) < ret)
+            ret = unit << shift;
+    }
+    return ret;
+}
+
+void TimerWheel::cascade(unsigned level, unsigned index) {
+    // Detached first, the timers may be put into the same slot again.
+    Link& head = slots_[level * SLOTS + index];
+    Link pending;
+    pending.next = head.next;
+    pending.prev = head.prev;
+    pending.next->prev = &pending;
+    pending.prev->next = &pending;
+    head.prev = head.next = &head;
+    occupied_[level] &= ~(1ULL << index);
+    while (pending.next != &pending) {
+        auto& timer = static_cast<Timer&>(*pending.next);
+        pending.next = timer.next;
+        timer.next->prev = &pending;
+        link(timer);
+    }
+}
+
+size_t TimerWheel::expire(unsigned index) {
+    Link& head = slots_[index];
+    if (head.next == &head)
+        return 0;
+    // Detached first, so the callbacks may arm and cancel any timers.
+    Link pending;
+    pending.next = head.next;
+    pending.prev = head.prev;
+    pending.next->prev = &pending;
+    pending.prev->next = &pending;
+    head.prev = head.next = &head;
+    occupied_[0] &= ~(1ULL << index);
+    size_t expired = 0;
+    while (pending.next != &pending) {
+        auto& timer = static_cast<Timer&>(*pending.next);
+        pending.next = timer.next;
+        timer.next->prev = &pending;
+        timer.prev = timer.next = nullptr;
+        timer.wheel_ = nullptr;
+        --count_;
+        ++expired;
+        if (timer.callback)
+            timer.callback();
+    }
+    return expired;
+}
+
+} // namespace tab
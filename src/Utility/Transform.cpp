@@ -60,6 +60,20 @@ std::string& LowercaseToUpper(std::string& str) {
 } // LowercaseToUpper
 
 
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        char x = a[i], y = b[i];
+        if ('A' <= x && x <= 'Z') x += 32;
+        if ('A' <= y && y <= 'Z') y += 32;
+        if (x != y)
+            return false;
+    }
+    return true;
+} // EqualsIgnoreCase
+
+
 unsigned long long HexStrToULL(const std::string& str) {
     if (str.size() > LLONG_MAX)
         return 0;
@@ -0,0 +1,166 @@
+/**
+ * @file main.cpp
+ * @brief Test HttpAsyncClient with a keep-alive server running in this
+ *        program, which counts the connections accepted.
+ *
+ * @note Usage: test-async [requests] [port]
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "EzNet.hpp"
+#include "EzNet/HTTP/HTTP_AsyncClient.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+atomic<int> accepted(0);
+
+// Answer the requests on a connection until it is closed. "/slow" is never
+// answered, and "/chunked" is answered with a chunked body.
+void Answer(tab::StreamSocket client) {
+    string data;
+    char buf[4096];
+    for (int n; (n = client.recv(buf, sizeof(buf))) > 0;) {
+        data.append(buf, n);
+        size_t end;
+        while ((end = data.find("\r\n\r\n")) != string::npos) {
+            string path = data.substr(data.find(' ') + 1);
+            path = path.substr(0, path.find(' '));
+            data.erase(0, end + 4);
+            if (path == "/slow")
+                continue;
+            if (path == "/chunked") {
+                client.send(string("HTTP/1.1 200 OK\r\n"
+                                   "Transfer-Encoding: chunked\r\n\r\n"
+                                   "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n"));
+                continue;
+            }
+            client.send("HTTP/1.1 200 OK\r\nContent-Length: " +
+                        to_string(path.size()) + "\r\n\r\n" + path);
+        }
+    }
+}
+
+void Serve(tab::ServerSocket& server) {
+    try {
+        for (;;) {
+            auto client = server.accept();
+            ++accepted;
+            thread(Answer, move(client)).detach();
+        }
+    }
+    catch (const exception&) {
+        // The server is closed when exiting.
+    }
+}
+
+int main(int argc, char** argv) {
+    int requests = argc > 1 ? stoi(argv[1]) : 2000;
+    auto port = static_cast<port_t>(argc > 2 ? stoul(argv[2]) : 8084);
+    tab::ServerSocket server("127.0.0.1", port);
+    if (!server.bind() || !server.listen(1024)) {
+        cout << "Cannot listen on port " << port << "." << endl;
+        return 1;
+    }
+    thread(Serve, ref(server)).detach();
+
+    string base = "http://127.0.0.1:" + to_string(port);
+    auto loop = make_shared<tab::HttpEventLoop>();
+    tab::HttpAsyncClient cli(loop);
+
+    cout << "Task 1: a request with a future." << endl;
+    auto resp = cli.get(tab::URL(base + "/hello")).get();
+    cout << "Code: " << (int)resp.getCode() << ", body: " << resp.getBody()
+         << endl;
+
+    cout << "Task 2: " << requests << " requests at the same time." << endl;
+    atomic<int> done(0), failed(0), wrong(0);
+    auto start = steady_clock::now();
+    for (int i = 0; i < requests; ++i) {
+        string path = "/" + to_string(i);
+        cli.request(tab::URL(base + path),
+            tab::HttpRequest(tab::HTTP::REQ_GET, "/"),
+            [&, path](exception_ptr error, tab::HttpResponse& resp) {
+                if (error)
+                    ++failed;
+                else if (resp.getBody() != path)
+                    ++wrong;
+                ++done;
+            });
+    }
+    while (done < requests)
+        this_thread::sleep_for(milliseconds(1));
+    auto ms = duration_cast<milliseconds>(steady_clock::now() - start);
+    cout << "Failed: " << failed << ", wrong: " << wrong << ", "
+         << ms.count() << " ms, " << accepted << " connections." << endl;
+
+    cout << "Task 3: the idle connections are used again." << endl;
+    int before = accepted;
+    for (int i = 0; i < 100; ++i)
+        cli.get(tab::URL(base + "/again")).get();
+    cout << "New connections: " << accepted - before << " (expected 0)"
+         << endl;
+
+    cout << "Task 4: a chunked response." << endl;
+    resp = cli.get(tab::URL(base + "/chunked")).get();
+    cout << "Body: " << resp.getBody() << endl;
+
+    cout << "Task 5: concurrent requests keeping 1 idle connection." << endl;
+    cli.options().max_idle_per_host = 1;
+    done = 0;
+    failed = 0;
+    wrong = 0;
+    for (int i = 0; i < 8; ++i) {
+        cli.request(tab::URL(base + "/one"),
+            tab::HttpRequest(tab::HTTP::REQ_GET, "/"),
+            [&](exception_ptr error, tab::HttpResponse& resp) {
+                if (error)
+                    ++failed;
+                else if (resp.getBody() != "/one")
+                    ++wrong;
+                ++done;
+            });
+    }
+    while (done < 8)
+        this_thread::sleep_for(milliseconds(1));
+    before = accepted;
+    cli.get(tab::URL(base + "/one")).get();
+    cout << "Failed: " << failed << ", wrong: " << wrong
+         << ", new connections after: " << accepted - before
+         << " (expected 0)" << endl;
+
+    cout << "Task 6: timeout." << endl;
+    cli.options().timeout_milliseconds = 200;
+    try {
+        cli.get(tab::URL(base + "/slow")).get();
+        cout << "Not timed out." << endl;
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+
+    cout << "Task 7: connection refused." << endl;
+    try {
+        cli.get(tab::URL("http://127.0.0.1:1/")).get();
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+
+    cout << "Task 8: the loop is stopped." << endl;
+    auto pending = cli.get(tab::URL(base + "/slow"));
+    loop->stop();
+    try {
+        pending.get();
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include "EzNet/HTTP/HTTP_Request.hpp"
+#include "EzNet/HTTP/HTTP_Response.hpp"
+
+using namespace std;
+using namespace std::chrono;
+using namespace tab;
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    ++ allocations;
+    if (void* p = malloc(size))
+        return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+const string raw_request(
+    "GET /index.html HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) Gecko/20100101 Firefox/120.0\r\n"
+    "Accept: text/html,application/xhtml+xml\r\n"
+    "Accept-Language: en-US,en;q=0.5\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Connection: keep-alive\r\n"
+    "Cache-Control: max-age=0\r\n"
+    "X-Request-Id: 6f1c2a9e\r\n"
+    "\r\n");
+
+// Parse a request, and make the response of it.
+size_t RoundTrip() {
+    auto request = HttpRequest::parse(raw_request);
+    HttpResponse response;
+    auto& headers = response.getHeaders();
+    headers.addHeader(HTTP::CONTENT_TYPE, "text/html");
+    headers.addHeader(HTTP::SERVER, "EzNet");
+    headers.addHeader(HTTP::CACHE_CONTROL, "no-cache");
+    headers.addHeader(HTTP::CONNECTION, 
+                      request.headers().find(HTTP::CONNECTION));
+    headers.addHeader("X-Request-Id", request.headers().find("X-Request-Id"));
+    headers.addHeader(HTTP::CONTENT_LENGTH, "0");
+    return response.getStr().size();
+}
+
+int main(int argc, char** argv) {
+    size_t times = 200000;
+    if (argc > 1)
+        times = stoull(argv[1]);
+    size_t sum = RoundTrip();
+    cout << "Response: " << sum << " bytes." << endl;
+
+    allocations = 0;
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < times; ++i)
+        sum += RoundTrip();
+    auto stop = steady_clock::now();
+    double ns = duration_cast<nanoseconds>(stop - start).count();
+    cout << "Round trip: " << ns / times << " ns, " 
+         << double(allocations) / times << " allocations. (" 
+         << sum << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "EzNet/HTTP/HTTP_Header.hpp"
+
+using namespace std;
+using namespace tab;
+using namespace HTTP;
+
+// The lookup used before, for comparison.
+HeaderFieldName LinearLookup(const string& name) {
+    for (size_t i = 1; i <= WWW_AUTHENTICATE; ++i)
+        if (name == HeaderKeyName[i])
+            return HeaderFieldName(i);
+    return NONE;
+}
+
+int main(void) {
+    size_t failed = 0;
+    for (size_t i = 1; i <= WWW_AUTHENTICATE; ++i) {
+        string name = HeaderKeyName[i], lower = name, upper = name;
+        transform(name.begin(), name.end(), lower.begin(), ::tolower);
+        transform(name.begin(), name.end(), upper.begin(), ::toupper);
+        if (HeaderFieldStringToEnum(name) != HeaderFieldName(i) ||
+            HeaderFieldStringToEnum(lower) != HeaderFieldName(i) ||
+            HeaderFieldStringToEnum(upper) != HeaderFieldName(i)) {
+            cout << "Failed: " << name << endl;
+            ++ failed;
+        }
+    }
+    cout << "Known names checked, " << failed << " failed." << endl;
+
+    for (const char* name : {"", "X-Request-Id", "Content-Lengths",
+                             "Content-Lengt", "Content_Length", "Hos",
+                             "content-length\r"})
+        cout << "[" << name << "]: " << HeaderFieldStringToEnum(name)
+             << " (0)" << endl;
+    cout << "[content-length]: " << HeaderFieldStringToEnum("content-length")
+         << " (" << CONTENT_LENGTH << ")" << endl;
+
+    // Headers find the common ones whatever the case is.
+    Headers headers;
+    headers.addHeader("content-type", "text/plain");
+    headers.addHeader("X-Custom", "1");
+    cout << "Content-Type: " << headers.find(CONTENT_TYPE) << endl;
+    cout << "CONTENT-TYPE: " << headers.find("CONTENT-TYPE") << endl;
+    cout << headers.getStr();
+
+    const vector<string> names{"Host", "User-Agent", "Accept", 
+        "Accept-Encoding", "Accept-Language", "Connection", "Cookie", 
+        "Upgrade-Insecure-Requests", "Cache-Control", "Content-Length"};
+    const size_t try_times = 2000000;
+    size_t sum = 0;
+    clock_t begin = clock();
+    for (size_t i = 0; i < try_times; ++i)
+        sum += HeaderFieldStringToEnum(names[i % names.size()]);
+    double hash_cost = double(clock() - begin) / CLOCKS_PER_SEC;
+    begin = clock();
+    for (size_t i = 0; i < try_times; ++i)
+        sum += LinearLookup(names[i % names.size()]);
+    double linear_cost = double(clock() - begin) / CLOCKS_PER_SEC;
+    cout << "Look up " << try_times << " names, hash: " << hash_cost
+         << " s, linear: " << linear_cost << " s. (" << sum << ")" << endl;
+    return failed == 0 ? 0 : 1;
+}
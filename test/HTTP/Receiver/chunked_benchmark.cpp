@@ -0,0 +1,76 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "EzNet.hpp"
+#include "EzNet/Utility/IO/IO.hpp"
+
+#include "../../../src/HTTP/Receiver.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+// Serve one chunked response of 'total' bytes, in chunks of 'chunk' bytes.
+void Serve(tab::ServerSocket& server, size_t total, size_t chunk) {
+    auto client = server.accept();
+    char request[1024];
+    client.recv(request, sizeof(request));
+
+    // About 1 MiB of chunks, sent repeatedly.
+    string block;
+    size_t per_block = 0;
+    char size_line[32];
+    snprintf(size_line, sizeof(size_line), "%zx;ext=1\r\n", chunk);
+    while (block.size() < (1 << 20)) {
+        block += size_line;
+        block.append(chunk, 'x');
+        block += "\r\n";
+        per_block += chunk;
+    }
+
+    string head("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n");
+    client.send(head);
+    for (size_t sent = 0; sent < total; sent += per_block)
+        client.send(block.data(), static_cast<int>(block.size()));
+    client.send(string("0\r\nX-Trailer: done\r\n\r\n"));
+}
+
+int main(int argc, char** argv) {
+    size_t gigabytes = argc > 1 ? stoull(argv[1]) : 2;
+    size_t chunk = argc > 2 ? stoull(argv[2]) : 16384;
+    auto port = static_cast<port_t>(argc > 3 ? stoul(argv[3]) : 8082);
+    size_t total = gigabytes << 30;
+
+    tab::ServerSocket server("127.0.0.1", port);
+    int on = 1;
+    setsockopt(server.get(), SOL_SOCKET, SO_REUSEADDR, 
+               (const char*)&on, sizeof(on));
+    if (!server.bind() || !server.listen()) {
+        cout << "Cannot listen on port " << port << "." << endl;
+        return 1;
+    }
+    thread t(Serve, ref(server), total, chunk);
+
+    tab::StreamSocket s(AF_INET);
+    s.connect(tab::Address4("127.0.0.1", port));
+    s.send(string("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+
+    static char buffer[65536];
+    size_t received = 0;
+    tab::NullWriter null_writer;
+    tab::Receiver receiver(buffer, sizeof(buffer), 
+        [&](void* p, size_t n) { received += n; return null_writer(p, n); });
+    auto start = steady_clock::now();
+    receiver.receive(&s);
+    auto stop = steady_clock::now();
+    t.join();
+
+    double sec = duration_cast<microseconds>(stop - start).count() / 1e6;
+    cout << "Received " << received << " bytes in chunks of " << chunk 
+         << " bytes, " << sec << " s, " << received / sec / (1 << 20) 
+         << " MiB/s." << endl;
+    cout << "Trailer: " << receiver.resp_.getHeaders().find("X-Trailer") 
+         << endl;
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "EzNet/HTTP/HTTP_Request.hpp"
+#include "EzNet/HTTP/HTTP_RequestView.hpp"
+#include "EzNet/Utility/General/Scan.hpp"
+
+using namespace std;
+using namespace std::chrono;
+using namespace tab;
+
+// A request with 60 header fields of 1 KiB values, about 62 KiB in total.
+string LargeRequest() {
+    string ret("GET /index.html HTTP/1.1\r\n");
+    for (int i = 0; i < 60; ++i) {
+        ret.append("X-Custom-Header-").append(to_string(i)).append(": ");
+        for (int j = 0; j < 1024; ++j)
+            ret.push_back(char('a' + (i + j) % 26));
+        ret.append("\r\n");
+    }
+    ret.append("\r\n");
+    return ret;
+}
+
+template <typename Func>
+double Throughput(const string& raw, size_t times, Func f) {
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < times; ++i)
+        f(raw);
+    double s = duration_cast<duration<double>>(steady_clock::now() - start)
+                   .count();
+    return double(raw.size()) * times / s / 1e9;
+}
+
+int main(int argc, char** argv) {
+    size_t times = argc > 1 ? stoull(argv[1]) : 20000;
+    string raw = LargeRequest();
+    cout << "Request size: " << raw.size() << " bytes, parse " << times
+         << " times." << endl;
+
+    const char* names[] = {"Scalar", "SSE2  ", "AVX2  "};
+    for (auto k : {ScanKernel::SCALAR, ScanKernel::SSE2, ScanKernel::AVX2}) {
+        if (!SetScanKernel(k)) {
+            cout << names[int(k)] << ": not supported." << endl;
+            continue;
+        }
+        size_t lines = 0;
+        double scan = Throughput(raw, times, [&lines](const string& s) {
+            const char* p = s.data();
+            const char* end = p + s.size();
+            for (; (p = ScanLineEnd(p, end)) != end; p += 2)
+                ++ lines;
+        });
+        HttpRequestView view;
+        double parse_view = Throughput(raw, times, [&view](const string& s) {
+            view.parse(s);
+        });
+        double parse_copy = Throughput(raw, times / 10, [](const string& s) {
+            HttpRequest::parse(s);
+        });
+        cout << names[int(k)] << ": line scanning " << scan << " GB/s, "
+             << "HttpRequestView::parse() " << parse_view << " GB/s, "
+             << "HttpRequest::parse() " << parse_copy << " GB/s "
+             << "(" << lines / times << " lines, "
+             << view.headerCount() << " headers)" << endl;
+    }
+    return 0;
+}
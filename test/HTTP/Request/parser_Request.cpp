@@ -0,0 +1,100 @@
+#include <iostream>
+#include "EzNet/HTTP/HTTP_RequestParser.hpp"
+
+using namespace std;
+using namespace tab;
+
+using Status = HttpRequestParser::Status;
+
+const char* Name(Status s) {
+    switch (s) {
+    case Status::NEED_MORE: return "NEED_MORE";
+    case Status::COMPLETE:  return "COMPLETE";
+    case Status::INVALID:   return "INVALID";
+    case Status::TOO_LARGE: return "TOO_LARGE";
+    }
+    return "?";
+}
+
+// Feed 'raw' in pieces of 'step' bytes.
+Status FeedBy(HttpRequestParser& parser, const string& raw, size_t step) {
+    parser.reset();
+    Status s = Status::NEED_MORE;
+    size_t pos = 0, consumed = 0;
+    while (s == Status::NEED_MORE && pos < raw.size()) {
+        size_t n = min(step, raw.size() - pos);
+        s = parser.feed(raw.data() + pos, n, consumed);
+        pos += consumed;
+    }
+    return s;
+}
+
+void Print(const char* title, HttpRequestParser& parser, Status s) {
+    auto& req = parser.request();
+    cout << title << ": " << Name(s);
+    if (s == Status::COMPLETE)
+        cout << ", " << req.getMethodName() << " " << req.getURI()
+             << " HTTP/" << req.getVersion() << ", " << req.headerCount()
+             << " header(s), body [" << req.body() << "]";
+    cout << endl;
+}
+
+int main(void) {
+    const string fixed(
+        "POST /upload HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Content-Length: 11\r\n"
+        "\r\n"
+        "hello world");
+    const string chunked(
+        "POST /chunked HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5;name=value\r\n"
+        "hello\r\n"
+        "6\r\n"
+        " world\r\n"
+        "0\r\n"
+        "Checksum: none\r\n"
+        "\r\n");
+
+    HttpRequestParser parser;
+    Print("Fixed, at once", parser, FeedBy(parser, fixed, fixed.size()));
+    Print("Fixed, byte by byte", parser, FeedBy(parser, fixed, 1));
+    Print("Fixed, by 7 bytes", parser, FeedBy(parser, fixed, 7));
+    Print("Chunked, at once", parser, FeedBy(parser, chunked, chunked.size()));
+    Print("Chunked, byte by byte", parser, FeedBy(parser, chunked, 1));
+    Print("Chunked, by 5 bytes", parser, FeedBy(parser, chunked, 5));
+
+    // Two requests in the same data.
+    string two = fixed + "GET /next HTTP/1.1\n\n";
+    size_t consumed = 0;
+    parser.reset();
+    auto s = parser.feed(two.data(), two.size(), consumed);
+    Print("First of two", parser, s);
+    cout << "Consumed: " << consumed << " of " << two.size() << endl;
+    parser.reset();
+    s = parser.feed(two.data() + consumed, two.size() - consumed, consumed);
+    Print("Second of two", parser, s);
+
+    // The body passed to a sink.
+    string sunk;
+    parser.setBodySink([&](const char* p, size_t n) { sunk.append(p, n); });
+    Print("Chunked, to a sink", parser, FeedBy(parser, chunked, 3));
+    cout << "Sink: [" << sunk << "]" << endl;
+    parser.setBodySink(nullptr);
+
+    Print("Incomplete", parser, FeedBy(parser, fixed.substr(0, 50), 1));
+    Print("Invalid request line", parser,
+          FeedBy(parser, "GET\r\n\r\n", 1));
+    Print("Invalid chunk size", parser,
+          FeedBy(parser, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+                         "\r\nxyz\r\n", 4));
+    parser.limits().max_body_size = 10;
+    Print("Body too large", parser, FeedBy(parser, fixed, 16));
+    Print("Chunks too large", parser, FeedBy(parser, chunked, 16));
+    parser.limits().max_head_size = 16;
+    Print("Head too large", parser, FeedBy(parser, fixed, 4));
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <ctime>
+#include "EzNet/HTTP/HTTP_RequestView.hpp"
+
+using namespace std;
+using namespace tab;
+using namespace HTTP;
+
+int main(void) {
+    const string raw(
+        "POST /index.html HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Accept-Encoding: *\r\n"
+        "content-length: 7\r\n"
+        "\r\n"
+        "ABCDEFG");
+    HttpRequestView view;
+    auto status = view.parse(raw);
+    cout << "Status: " << int(status) << " (0 is OK)" << endl;
+    cout << "Method: " << view.getMethodName() << " (" << view.getMethod() << ")" << endl;
+    cout << "URI: " << view.getURI() << endl;
+    cout << "Version: " << view.getVersion() << endl;
+    for (auto& h : view)
+        cout << "Header: [" << h.name << "] = [" << h.value << "]" << endl;
+    cout << "Content-Length: " << view.find(CONTENT_LENGTH) << endl;
+    cout << "Body: " << view.body() << endl;
+    cout << "--------" << endl;
+    cout << "Copied: " << endl << view.toRequest().getString() << endl;
+    cout << "--------" << endl;
+    cout << "Incomplete: " << int(view.parse(raw.substr(0, 30))) << " (1)" << endl;
+    cout << "Invalid: " << int(view.parse("GET\r\n\r\n")) << " (2)" << endl;
+
+    // The framing of the body, which must not be ambiguous.
+    const pair<const char*, const char*> framings[] = {
+        { "Overflowing length (2)",
+          "Content-Length: 18446744073709551621\r\n" },
+        { "Same lengths (0)", "Content-Length: 5\r\nContent-Length: 5\r\n" },
+        { "Different lengths (2)",
+          "Content-Length: 5\r\nContent-Length: 6\r\n" },
+        { "Chunked with a length (2)",
+          "Transfer-Encoding: chunked\r\nContent-Length: 5\r\n" },
+        { "Space before the colon (2)", "Content-Length : 5\r\n" },
+        { "Space before the name (2)", "Host: a\r\n Content-Length: 5\r\n" },
+        { "Tab in the name (2)", "Transfer-Encoding\t: chunked\r\n" },
+        { "Not a token (2)", "Content\"Length: 5\r\n" },
+        { "Token characters (0)", "X-!#$%&'*+.^_`|~: 1\r\n" },
+    };
+    for (auto& f : framings)
+        cout << f.first << ": "
+             << int(view.parse(string("POST / HTTP/1.1\r\n") + f.second + 
+                               "\r\n")) << endl;
+    const char* const codings[] = { "chunked", "gzip , Chunked ", "xchunked",
+                                    "chunked, gzip" };
+    for (auto c : codings) {
+        view.parse(string("POST / HTTP/1.1\r\nTransfer-Encoding: ") + c + 
+                   "\r\n\r\n");
+        cout << "Transfer-Encoding: " << c << " -> chunked: " 
+             << view.isChunked() << endl;
+    }
+
+    const size_t try_times = 1000000;
+    clock_t begin = clock();
+    for (size_t i = 0; i < try_times; ++i)
+        view.parse(raw);
+    double view_cost = double(clock() - begin) / CLOCKS_PER_SEC;
+    begin = clock();
+    for (size_t i = 0; i < try_times; ++i)
+        HttpRequest::parse(raw);
+    double copy_cost = double(clock() - begin) / CLOCKS_PER_SEC;
+    cout << "Parse " << try_times << " times, HttpRequestView: " << view_cost
+         << " s, HttpRequest: " << copy_cost << " s." << endl;
+    return 0;
+}
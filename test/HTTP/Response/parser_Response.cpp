@@ -0,0 +1,98 @@
+#include <iostream>
+#include "EzNet/HTTP/HTTP_ResponseParser.hpp"
+
+using namespace std;
+using namespace tab;
+
+using Status = HttpResponseParser::Status;
+
+const char* Name(Status s) {
+    switch (s) {
+    case Status::NEED_MORE: return "NEED_MORE";
+    case Status::COMPLETE:  return "COMPLETE";
+    case Status::INVALID:   return "INVALID";
+    case Status::TOO_LARGE: return "TOO_LARGE";
+    }
+    return "?";
+}
+
+// Feed 'raw' in pieces of 'step' bytes, and tell the end of the data
+// as the connection closed if 'closed'.
+Status FeedBy(HttpResponseParser& parser, const string& raw, size_t step,
+              bool closed = false) {
+    parser.reset();
+    Status s = Status::NEED_MORE;
+    size_t pos = 0, consumed = 0;
+    while (s == Status::NEED_MORE && pos < raw.size()) {
+        size_t n = min(step, raw.size() - pos);
+        s = parser.feed(raw.data() + pos, n, consumed);
+        pos += consumed;
+    }
+    if (s == Status::NEED_MORE && closed)
+        s = parser.finish();
+    return s;
+}
+
+void Print(const char* title, HttpResponseParser& parser, Status s) {
+    auto& resp = parser.response();
+    cout << title << ": " << Name(s);
+    if (s == Status::COMPLETE)
+        cout << ", " << (int)resp.getCode() << " HTTP/" << resp.getVersion()
+             << ", body [" << resp.getBody() << "], "
+             << (parser.reusable() ? "reusable" : "not reusable");
+    cout << endl;
+}
+
+int main(void) {
+    const string fixed(
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 11\r\n"
+        "Set-Cookie: id=1\r\n"
+        "\r\n"
+        "hello world");
+    const string chunked(
+        "HTTP/1.1 100 Continue\r\n"
+        "\r\n"
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5;name=value\r\n"
+        "hello\r\n"
+        "6\r\n"
+        " world\r\n"
+        "0\r\n"
+        "Checksum: none\r\n"
+        "\r\n");
+    const string until_close(
+        "HTTP/1.0 200 OK\r\n"
+        "\r\n"
+        "hello world");
+
+    HttpResponseParser parser;
+    Print("Fixed, at once", parser, FeedBy(parser, fixed, fixed.size()));
+    cout << "Cookies: " << parser.response().getCookies().size() << endl;
+    Print("Fixed, byte by byte", parser, FeedBy(parser, fixed, 1));
+    Print("Chunked, at once", parser, FeedBy(parser, chunked, chunked.size()));
+    cout << "Trailer: " << parser.response().getHeaders().find("Checksum")
+         << endl;
+    Print("Chunked, by 5 bytes", parser, FeedBy(parser, chunked, 5));
+    Print("Until closed", parser, FeedBy(parser, until_close, 4, true));
+    Print("Cut off", parser, FeedBy(parser, fixed.substr(0, 50), 8, true));
+    // Not chunked, so the body is delimited by closing.
+    Print("Unknown coding \"xchunked\"", parser,
+          FeedBy(parser, "HTTP/1.1 200 OK\r\nTransfer-Encoding: xchunked\r\n"
+                         "\r\n0\r\n\r\n", 64, true));
+
+    parser.reset();
+    parser.setNoBody();
+    size_t consumed = 0;
+    auto s = parser.feed(fixed.data(), fixed.size() - 11, consumed);
+    Print("Response to HEAD", parser, s);
+
+    Print("Invalid status line", parser,
+          FeedBy(parser, "HTTP/1.1 OK\r\n\r\n", 3));
+    parser.limits().max_body_size = 10;
+    Print("Body too large", parser, FeedBy(parser, fixed, 16));
+    Print("Chunks too large", parser, FeedBy(parser, chunked, 16));
+    return 0;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file file.cpp
+ * @brief Test the responses of HttpServer whose bodies are files, which
+ *        are written by sendfile(2) (splice(2) on io_uring), with the
+ *        ranges requested by "Range", requested by pipelining, and the
+ *        response to HEAD, which has no body.
+ *
+ * @note Usage: test-file [port] [uring]
+ * @note A file of 64 MiB named "file.bin" is written in the working
+ *       directory.
+ *
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <sys/stat.h>
+
+#include "EzNet.hpp"
+#include "EzNet/HTTP/HTTP_ResponseParser.hpp"
+#include "EzNet/HTTP/HTTP_Server.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+const char* const FILE_NAME = "file.bin";
+const size_t FILE_SIZE = 64 << 20;
+
+struct Case {
+    string          headers;
+    tab::HTTP::RespCode code;
+    size_t          first;  // of the body expected, in the file
+    size_t          size;
+};
+
+int main(int argc, char** argv) {
+    auto port = static_cast<port_t>(argc > 1 ? stoul(argv[1]) : 8093);
+
+    string content(FILE_SIZE, '\0');
+    for (size_t i = 0; i < FILE_SIZE; ++i)
+        content[i] = static_cast<char>('a' + i % 26 + i / 4096 % 3);
+    ofstream(FILE_NAME, ios::binary).write(content.data(), content.size());
+    struct stat st;
+    stat(FILE_NAME, &st);
+    string modified = tab::HTTP::FormatDate(st.st_mtime);
+
+    tab::HttpServer server;
+    auto& cfg = server.configTCP();
+    cfg.listen_address.set(
+        tab::URL("http://127.0.0.1:" + to_string(port) + "/").getHost()
+                                                              .getAddr());
+    if (argc > 2)
+        cfg.io_backend = tab::TcpServer::TcpConfig::IOBackend::IO_URING;
+    server.configHTTP().keep_alive = true;
+    server.registerEvent<tab::HttpRequestReceivedEvent>(
+        [](tab::HttpRequestReceivedEvent& e) {
+            if (e.getRequestView().getURI() == "/file")
+                e.getResponse().setFileBody(FILE_NAME);
+            else
+                e.getResponse().getBody() = "small";
+        });
+    server.start();
+
+    using tab::HTTP::RespCode;
+    const Case cases[] = {
+        { "",                                RespCode::OK, 0, FILE_SIZE },
+        { "Range: bytes=100-199\r\n",        RespCode::PARTIAL_CONTENT,
+                                             100, 100 },
+        { "Range: bytes=-50\r\n",            RespCode::PARTIAL_CONTENT,
+                                             FILE_SIZE - 50, 50 },
+        { "Range: bytes=4000-999999999\r\n", RespCode::PARTIAL_CONTENT,
+                                             4000, FILE_SIZE - 4000 },
+        { "Range: bytes=999999999-\r\n",
+          RespCode::REQUESTED_RANGE_NOT_SATISFIABLE, 0, 0 },
+        { "Range: bytes=0-9,20-29\r\n",      RespCode::OK, 0, FILE_SIZE },
+        { "Range: bytes=0-9\r\n"
+          "If-Range: Thu, 01 Jan 1970 00:00:00 GMT\r\n",
+                                             RespCode::OK, 0, FILE_SIZE },
+        { "Range: bytes=5-14\r\nIf-Range: " + modified + "\r\n",
+                                             RespCode::PARTIAL_CONTENT, 5, 10 },
+    };
+    const size_t count = sizeof(cases) / sizeof(cases[0]);
+    string requests;
+    for (auto& c : cases)
+        requests += "GET /file HTTP/1.1\r\nHost: localhost\r\n" +
+                    c.headers + "\r\nGET /small HTTP/1.1\r\n\r\n";
+
+    tab::StreamSocket cli(AF_INET);
+    cli.connect(cfg.listen_address.getAddr());
+    auto start = steady_clock::now();
+    cli.send(requests);
+
+    tab::HttpResponseParser parser;
+    parser.limits().max_body_size = 0;
+    char buf[65536];
+    size_t index = 0, wrong = 0, received = 0;
+    while (index < count * 2) {
+        int n = cli.recv(buf, sizeof(buf));
+        if (n <= 0) {
+            cout << "Closed after " << index << " responses." << endl;
+            break;
+        }
+        received += n;
+        const char* p = buf;
+        size_t left = n;
+        while (left > 0) {
+            size_t consumed = 0;
+            auto status = parser.feed(p, left, consumed);
+            p += consumed;
+            left -= consumed;
+            if (status != tab::HttpResponseParser::Status::COMPLETE)
+                break;
+            auto& resp = parser.response();
+            if (index % 2 == 1) {
+                if (resp.getBody() != "small")
+                    ++wrong;
+            }
+            else {
+                auto& c = cases[index / 2];
+                if (resp.getCode() != c.code ||
+                    resp.getBody() != content.substr(c.first, c.size) ||
+                    resp.getHeaders().find(tab::HTTP::LAST_MODIFIED)
+                        != modified) {
+                    cout << "Case " << index / 2 << " is wrong: "
+                         << (int)resp.getCode() << ", "
+                         << resp.getBody().size() << " bytes." << endl;
+                    ++wrong;
+                }
+                else if (c.code != RespCode::OK) {
+                    cout << "Case " << index / 2 << ": "
+                         << (int)resp.getCode() << ", Content-Range: "
+                         << resp.getHeaders().find(
+                                tab::HTTP::CONTENT_RANGE) << endl;
+                }
+            }
+            ++index;
+            parser.reset();
+        }
+    }
+    double ms = duration<double, milli>(steady_clock::now() - start).count();
+    cout << "Responses: " << index << ", wrong: " << wrong << ", "
+         << (received >> 20) << " MiB in " << ms << " ms" << endl;
+
+    // The response to HEAD has the fields of the file but no body, and the
+    // next response follows its head.
+    cli.send("HEAD /file HTTP/1.1\r\nRange: bytes=0-9\r\n\r\n"
+             "GET /small HTTP/1.1\r\n\r\n");
+    parser.reset();
+    parser.setNoBody();
+    size_t heads = 0;
+    while (heads < 2) {
+        int n = cli.recv(buf, sizeof(buf));
+        if (n <= 0)
+            break;
+        const char* p = buf;
+        size_t left = n;
+        while (left > 0) {
+            size_t consumed = 0;
+            auto status = parser.feed(p, left, consumed);
+            p += consumed;
+            left -= consumed;
+            if (status != tab::HttpResponseParser::Status::COMPLETE)
+                break;
+            auto& resp = parser.response();
+            auto& headers = resp.getHeaders();
+            if (heads == 0)
+                cout << "HEAD: " << (int)resp.getCode() << ", Content-Length: "
+                     << headers.find(tab::HTTP::CONTENT_LENGTH)
+                     << ", Accept-Ranges: "
+                     << headers.find(tab::HTTP::ACCEPT_RANGES)
+                     << ", Last-Modified "
+                     << (headers.find(tab::HTTP::LAST_MODIFIED) == modified
+                             ? "kept" : "wrong") << endl;
+            else
+                cout << "Next: " << (int)resp.getCode() << ", "
+                     << resp.getBody() << endl;
+            ++heads;
+            parser.reset();
+        }
+    }
+    if (heads < 2)
+        cout << "Closed after " << heads << " of 2 responses." << endl;
+    server.stop();
+    remove(FILE_NAME);
+    return 0;
+}
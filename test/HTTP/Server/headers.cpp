@@ -0,0 +1,151 @@
+/**
+ * @file headers.cpp
+ * @brief Test the cached status lines, the "Date" and the static header
+ *        blocks of HttpServer, and compare the time of rendering a head
+ *        with them and with the fields set for each response.
+ *
+ * @note Usage: test-headers [port]
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "EzNet.hpp"
+#include "EzNet/HTTP/HTTP_ResponseParser.hpp"
+#include "EzNet/HTTP/HTTP_Server.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+tab::HTTP::Headers CorsHeaders() {
+    tab::HTTP::Headers ret;
+    ret.addHeader(tab::HTTP::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
+    ret.addHeader(tab::HTTP::ACCESS_CONTROL_ALLOW_METHODS, "GET, POST");
+    ret.addHeader(tab::HTTP::ACCESS_CONTROL_MAX_AGE, "86400");
+    return ret;
+}
+
+int main(int argc, char** argv) {
+    auto port = static_cast<port_t>(argc > 1 ? stoul(argv[1]) : 8094);
+    tab::HttpServer server;
+    auto& cfg = server.configTCP();
+    cfg.listen_address.set(
+        tab::URL("http://127.0.0.1:" + to_string(port) + "/").getHost()
+                                                              .getAddr());
+    server.configHTTP().keep_alive = true;
+    tab::HTTP::Headers common;
+    common.addHeader(tab::HTTP::SERVER, "EzNet");
+    server.addStaticHeaders(common, true);
+    auto cors = server.addStaticHeaders(CorsHeaders());
+    server.registerEvent<tab::HttpRequestReceivedEvent>(
+        [cors](tab::HttpRequestReceivedEvent& e) {
+            auto uri = e.getRequestView().getURI();
+            auto& sl = e.getResponse().getStatusLine();
+            sl.setVersion("1.1");
+            if (uri == "/api")
+                e.addStaticHeaders(cors);
+            if (uri == "/missing") {
+                sl.setCode(tab::HTTP::RespCode::NOT_FOUND);
+                sl.setPhrase("Not Found");
+            }
+            if (uri == "/gone") { // the same code with another phrase
+                sl.setCode(tab::HTTP::RespCode::NOT_FOUND);
+                sl.setPhrase("Gone Away");
+            }
+            if (uri == "/dated")
+                e.getResponse().getHeaders()[tab::HTTP::DATE] = "yesterday";
+            e.getResponse().getBody() = string(uri);
+        });
+    server.start();
+
+    const char* const uris[] = { "/", "/api", "/missing", "/gone",
+                                 "/missing", "/dated" };
+    const size_t count = sizeof(uris) / sizeof(uris[0]);
+    string requests;
+    for (auto uri : uris)
+        requests += string("GET ") + uri + " HTTP/1.1\r\n\r\n";
+
+    tab::StreamSocket cli(AF_INET);
+    cli.connect(cfg.listen_address.getAddr());
+    cli.send(requests);
+
+    tab::HttpResponseParser parser;
+    char buf[65536];
+    size_t index = 0;
+    while (index < count) {
+        int n = cli.recv(buf, sizeof(buf));
+        if (n <= 0) {
+            cout << "Closed after " << index << " responses." << endl;
+            break;
+        }
+        const char* p = buf;
+        size_t left = n;
+        while (left > 0) {
+            size_t consumed = 0;
+            auto status = parser.feed(p, left, consumed);
+            p += consumed;
+            left -= consumed;
+            if (status != tab::HttpResponseParser::Status::COMPLETE)
+                break;
+            auto& resp = parser.response();
+            auto& headers = resp.getHeaders();
+            cout << uris[index] << ": " << (int)resp.getCode() << " "
+                 << resp.getStatusLine().getPhrase()
+                 << " | Date: " << headers.find(tab::HTTP::DATE)
+                 << " | Server: " << headers.find(tab::HTTP::SERVER)
+                 << " | CORS: "
+                 << headers.find(tab::HTTP::ACCESS_CONTROL_ALLOW_ORIGIN)
+                 << endl;
+            ++index;
+            parser.reset();
+        }
+    }
+    server.stop();
+
+    // Render the same head in both ways.
+    const int rounds = 1000000;
+    tab::HttpResponse resp;
+    resp.getStatusLine().setVersion("1.1");
+    resp.getHeaders().addHeader(tab::HTTP::CONTENT_LENGTH, "5");
+    string out, blocks = common.getStr() + CorsHeaders().getStr();
+    size_t total = 0;
+    auto start = steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        tab::HttpResponse r = resp;
+        r.getHeaders()[tab::HTTP::SERVER] = "EzNet";
+        for (auto& line : {
+                 make_pair(tab::HTTP::ACCESS_CONTROL_ALLOW_ORIGIN, "*"),
+                 make_pair(tab::HTTP::ACCESS_CONTROL_ALLOW_METHODS,
+                           "GET, POST"),
+                 make_pair(tab::HTTP::ACCESS_CONTROL_MAX_AGE, "86400") })
+            r.getHeaders()[line.first] = line.second;
+        r.getHeaders()[tab::HTTP::DATE] =
+            tab::HTTP::FormatDate(time(nullptr));
+        out.clear();
+        out.append("HTTP/1.1 ").append(to_string(200)).append(" OK\r\n");
+        r.appendFieldsTo(out);
+        total += out.size();
+    }
+    auto per_field = duration<double, nano>(
+        steady_clock::now() - start).count() / rounds;
+    start = steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        tab::HttpResponse r = resp;
+        out.clear();
+        r.getStatusLine().appendTo(out);
+        out.append("Date: ", 6);
+        out.append(tab::HTTP::CurrentDate(), tab::HTTP::DATE_LENGTH);
+        out.append("\r\n", 2);
+        out.append(blocks);
+        r.appendFieldsTo(out);
+        total -= out.size();
+    }
+    auto cached = duration<double, nano>(
+        steady_clock::now() - start).count() / rounds;
+    cout << "Fields set for each response: " << per_field << " ns/head, "
+         << "cached: " << cached << " ns/head, size "
+         << (total == 0 ? "equal" : "differs") << endl;
+    return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file large.cpp
+ * @brief Test the responses of HttpServer written by gathering writes, 
+ *        with bodies from a few bytes to many times the socket buffer,
+ *        requested by pipelining.
+ *
+ * @note Usage: test-large [port] [uring]
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "EzNet.hpp"
+#include "EzNet/HTTP/HTTP_ResponseParser.hpp"
+#include "EzNet/HTTP/HTTP_Server.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+// The body of "/<size>" is 'size' bytes of a pattern.
+string Body(size_t size) {
+    string ret(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+        ret[i] = static_cast<char>('a' + i % 26);
+    return ret;
+}
+
+int main(int argc, char** argv) {
+    auto port = static_cast<port_t>(argc > 1 ? stoul(argv[1]) : 8092);
+    tab::HttpServer server;
+    auto& cfg = server.configTCP();
+    cfg.listen_address.set(
+        tab::URL("http://127.0.0.1:" + to_string(port) + "/").getHost()
+                                                              .getAddr());
+    if (argc > 2)
+        cfg.io_backend = tab::TcpServer::TcpConfig::IOBackend::IO_URING;
+    server.configHTTP().keep_alive = true;
+    server.registerEvent<tab::HttpRequestReceivedEvent>(
+        [](tab::HttpRequestReceivedEvent& e) {
+            e.getResponse().getBody() = 
+                Body(stoul(e.getRequest().getURI().substr(1)));
+        });
+    server.start();
+
+    const size_t sizes[] = { 0, 10, 1023, 1024, 100000, 
+                             32 << 20, 5, 3 << 20 };
+    string requests;
+    for (auto size : sizes)
+        requests += "GET /" + to_string(size) + " HTTP/1.1\r\n"
+                    "Host: localhost\r\n\r\n";
+
+    tab::StreamSocket cli(AF_INET);
+    cli.connect(cfg.listen_address.getAddr());
+    auto start = steady_clock::now();
+    cli.send(requests);
+
+    tab::HttpResponseParser parser;
+    parser.limits().max_body_size = 0;
+    char buf[65536];
+    size_t index = 0, wrong = 0, received = 0;
+    while (index < sizeof(sizes) / sizeof(sizes[0])) {
+        int n = cli.recv(buf, sizeof(buf));
+        if (n <= 0) {
+            cout << "Closed after " << index << " responses." << endl;
+            break;
+        }
+        received += n;
+        const char* p = buf;
+        size_t left = n;
+        while (left > 0) {
+            size_t consumed = 0;
+            auto status = parser.feed(p, left, consumed);
+            p += consumed;
+            left -= consumed;
+            if (status != tab::HttpResponseParser::Status::COMPLETE)
+                break;
+            if (parser.response().getBody() != Body(sizes[index]))
+                ++wrong;
+            ++index;
+            parser.reset();
+        }
+    }
+    double ms = duration<double, milli>(steady_clock::now() - start).count();
+    cout << "Responses: " << index << ", wrong: " << wrong << ", "
+         << (received >> 20) << " MiB in " << ms << " ms" << endl;
+    server.stop();
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file pipeline.cpp
+ * @brief Test the pipelined requests of HttpServer: several requests sent
+ *        at once, a request split across reads, and a partial request
+ *        following complete ones. The responses are expected in order,
+ *        and the ones to the requests read together in one write.
+ *
+ * @note Usage: test-pipeline [port] [uring]
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EzNet.hpp"
+#include "EzNet/HTTP/HTTP_ResponseParser.hpp"
+#include "EzNet/HTTP/HTTP_Server.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Receive 'count' responses, and print their bodies and how many reads
+ * they took.
+ */
+void Expect(const char* title, tab::StreamSocket& cli, size_t count) {
+    tab::HttpResponseParser parser;
+    vector<string> bodies;
+    char buf[65536];
+    int reads = 0;
+    while (bodies.size() < count) {
+        int n = cli.recv(buf, sizeof(buf));
+        if (n <= 0)
+            break;
+        ++reads;
+        const char* p = buf;
+        size_t left = n;
+        while (left > 0) {
+            size_t consumed = 0;
+            auto status = parser.feed(p, left, consumed);
+            p += consumed;
+            left -= consumed;
+            if (status != tab::HttpResponseParser::Status::COMPLETE)
+                break;
+            bodies.push_back(parser.response().getBody());
+            parser.reset();
+        }
+    }
+    cout << title << ": ";
+    for (auto& b : bodies)
+        cout << b << " ";
+    cout << "(" << bodies.size() << " of " << count << " in " << reads
+         << " read(s))" << endl;
+}
+
+int main(int argc, char** argv) {
+    auto port = static_cast<port_t>(argc > 1 ? stoul(argv[1]) : 8096);
+    tab::HttpServer server;
+    auto& cfg = server.configTCP();
+    cfg.listen_address.set(
+        tab::URL("http://127.0.0.1:" + to_string(port) + "/").getHost()
+                                                              .getAddr());
+    if (argc > 2)
+        cfg.io_backend = tab::TcpServer::TcpConfig::IOBackend::IO_URING;
+    server.configHTTP().keep_alive = true;
+    server.registerEvent<tab::HttpRequestReceivedEvent>(
+        [](tab::HttpRequestReceivedEvent& e) {
+            auto& view = e.getRequestView();
+            e.getResponse().getStatusLine().setVersion("1.1");
+            e.getResponse().getBody() =
+                string(view.getURI()) + string(view.body());
+        });
+    server.start();
+
+    tab::StreamSocket cli(AF_INET);
+    cli.connect(cfg.listen_address.getAddr());
+
+    // Answered by one write, in order.
+    cli.send("GET /1 HTTP/1.1\r\n\r\n"
+             "POST /2 HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc"
+             "GET /3 HTTP/1.1\r\n\r\n"
+             "GET /4 HTTP/1.1\r\n\r\n");
+    Expect("Sent at once (/1 /2abc /3 /4, 1 read)", cli, 4);
+
+    // The head and the body split across reads.
+    cli.send("GET /5 HT");
+    this_thread::sleep_for(milliseconds(50));
+    cli.send("TP/1.1\r\n\r\nPOST /6 HTTP/1.1\r\nContent-Length: 6\r\n\r\nde");
+    this_thread::sleep_for(milliseconds(50));
+    cli.send("fghi");
+    Expect("Split (/5 /6defghi)", cli, 2);
+
+    // The partial request waits for the rest.
+    cli.send("GET /7 HTTP/1.1\r\n\r\nGET /8 HTTP/1.1\r\n\r\nGET /9 HTT");
+    Expect("Partial last (/7 /8, 1 read)", cli, 2);
+    cli.send("P/1.1\r\n\r\n");
+    Expect("Rest of the partial (/9)", cli, 1);
+
+    server.stop();
+    return 0;
+}
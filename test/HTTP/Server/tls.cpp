@@ -0,0 +1,78 @@
+/**
+ * @file tls.cpp
+ * @brief Test HttpServer with TLS, requested by HttpClient.
+ *
+ * @note Usage: test-tls [port]
+ * @note "cert.pem" and "key.pem" are needed, which can be made by:
+ * @note openssl req -x509 -newkey rsa:2048 -nodes -keyout key.pem
+ * @note     -out cert.pem -days 1 -subj /CN=localhost
+ *
+ */
+
+#include <iostream>
+#include <string>
+
+#include "EzNet.hpp"
+#include "EzNet/HTTP/HTTP_Client.hpp"
+#include "EzNet/HTTP/HTTP_Server.hpp"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    auto port = static_cast<port_t>(argc > 1 ? stoul(argv[1]) : 8443);
+    tab::HttpServer server;
+    auto& cfg = server.configTCP();
+    cfg.listen_address.set(
+        tab::URL("https://127.0.0.1:" + to_string(port) + "/").getHost().getAddr());
+    cfg.concurrent_threads = 2;
+    cfg.tls_enable = true;
+    cfg.tls_certificate_file = "cert.pem";
+    cfg.tls_private_key_file = "key.pem";
+    cfg.tls_alpn_protocols = {"http/1.1"};
+    server.registerEvent<tab::HttpRequestReceivedEvent>(
+        [](tab::HttpRequestReceivedEvent& e) {
+            e.getResponse().getBody() = "Secure " + e.getRequest().getURI();
+        });
+    server.start();
+
+    cout << "Task 1: 20 requests by HttpClient." << endl;
+    tab::HttpClient cli;
+    string body;
+    auto writer = [&body](const void* data, size_t size) {
+        body.append((const char*)data, size);
+        return size;
+    };
+    int wrong = 0;
+    for (int i = 0; i < 20; ++i) {
+        auto s = cli.target(tab::URL("https://127.0.0.1:" + to_string(port) +
+                                     "/" + to_string(i)));
+        s.setWriter(writer);
+        body.clear();
+        s.request();
+        if (body != "Secure /" + to_string(i))
+            ++wrong;
+    }
+    cout << "Wrong: " << wrong << endl;
+
+    cout << "Task 2: a client speaking plain HTTP is refused." << endl;
+    tab::StreamSocket plain(AF_INET);
+    plain.connect(cfg.listen_address.getAddr());
+    plain.send(string("GET / HTTP/1.1\r\nHost: x\r\n\r\n"));
+    char buf[64];
+    cout << "Received: " << plain.recv(buf, sizeof(buf)) << " (expected <= 0"
+         << " or an alert)" << endl;
+
+    cout << "Task 3: the server still works." << endl;
+    auto s = cli.target(tab::URL("https://127.0.0.1:" + to_string(port) +
+                                 "/again"));
+    s.setWriter(writer);
+    body.clear();
+    s.request();
+    cout << "Body: " << body << endl;
+
+    auto stats = server.configTLS().getHandshakeStats();
+    cout << "Handshakes: " << stats.server_full << " full, "
+         << stats.server_resumed << " resumed" << endl;
+    server.stop();
+    return 0;
+}
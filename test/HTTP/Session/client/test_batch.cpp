@@ -0,0 +1,100 @@
+/**
+ * @file test_batch.cpp
+ * @brief Test the pipelined requests of HttpSessionClient.
+ *
+ * @note A keep-alive server runs in this program. It waits 20 ms before
+ * @note answering what it has read, like a server far away, and closes
+ * @note the connection after 8 responses.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EzNet.hpp"
+#include "EzNet/HTTP/HTTP_Client.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+void Answer(tab::StreamSocket client) {
+    string data;
+    char buf[4096];
+    int answered = 0;
+    for (int n; (n = client.recv(buf, sizeof(buf))) > 0;) {
+        data.append(buf, n);
+        this_thread::sleep_for(milliseconds(20));
+        string out;
+        size_t end;
+        while ((end = data.find("\r\n\r\n")) != string::npos) {
+            string path = data.substr(data.find(' ') + 1);
+            path = path.substr(0, path.find(' '));
+            data.erase(0, end + 4);
+            bool last = ++answered == 8;
+            out += "HTTP/1.1 200 OK\r\nContent-Length: " +
+                   to_string(path.size()) +
+                   (last ? "\r\nConnection: close" : "") + "\r\n\r\n" + path;
+            if (last)
+                break;
+        }
+        client.send(out);
+        if (answered == 8)
+            return;
+    }
+}
+
+void Serve(tab::ServerSocket& server) {
+    try {
+        for (;;)
+            thread(Answer, server.accept()).detach();
+    }
+    catch (const exception&) {
+        // The server is closed when exiting.
+    }
+}
+
+int main(int argc, char** argv) {
+    auto port = static_cast<port_t>(argc > 1 ? stoul(argv[1]) : 8085);
+    tab::ServerSocket server("127.0.0.1", port);
+    if (!server.bind() || !server.listen()) {
+        cout << "Cannot listen on port " << port << "." << endl;
+        return 1;
+    }
+    thread(Serve, ref(server)).detach();
+
+    tab::HttpClient cli;
+    auto s = cli.target(tab::URL("http://127.0.0.1:" + to_string(port) + "/"));
+    s.setWriter(tab::NullWriter());
+    s.setAutoJump(false);
+
+    const int n = 20;
+    cout << "Task 1: " << n << " requests one by one." << endl;
+    auto start = steady_clock::now();
+    for (int i = 0; i < n; ++i)
+        s.setURI("/" + to_string(i)).request();
+    cout << duration_cast<milliseconds>(steady_clock::now() - start).count()
+         << " ms" << endl;
+
+    cout << "Task 2: " << n << " requests in a batch." << endl;
+    vector<tab::HttpRequest> requests;
+    for (int i = 0; i < n; ++i)
+        requests.emplace_back(tab::HTTP::REQ_GET, "/" + to_string(i));
+    start = steady_clock::now();
+    auto responses = s.requestBatch(requests);
+    cout << duration_cast<milliseconds>(steady_clock::now() - start).count()
+         << " ms" << endl;
+    int wrong = 0;
+    for (int i = 0; i < n; ++i)
+        if (responses[i].getBody() != "/" + to_string(i))
+            ++wrong;
+    cout << "Responses: " << responses.size() << ", wrong: " << wrong << endl;
+
+    cout << "Task 3: 2 requests in flight at most." << endl;
+    responses = s.requestBatch(requests, 2);
+    cout << "Responses: " << responses.size() << ", last: "
+         << responses.back().getBody() << endl;
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file test_pool.cpp
+ * @brief Test the connection pool of HttpClient.
+ *
+ * @note A keep-alive server runs in this program, and it counts the
+ * @note connections accepted, which should be printed as expected.
+ *
+ */
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "EzNet.hpp"
+#include "EzNet/HTTP/HTTP_Client.hpp"
+
+using namespace std;
+
+atomic<int> accepted(0);
+
+// Answer the requests on a connection until it is closed,
+// or close it silently after answering "/drop".
+void Answer(tab::StreamSocket client) {
+    string data;
+    char buf[1024];
+    for (int n; (n = client.recv(buf, sizeof(buf))) > 0;) {
+        data.append(buf, n);
+        size_t end;
+        while ((end = data.find("\r\n\r\n")) != string::npos) {
+            string path = data.substr(data.find(' ') + 1);
+            path = path.substr(0, path.find(' '));
+            data.erase(0, end + 4);
+            string body = "response of " + path;
+            client.send("HTTP/1.1 200 OK\r\nContent-Length: " +
+                        to_string(body.size()) + "\r\n\r\n" + body);
+            if (path == "/drop")
+                return;
+        }
+    }
+}
+
+void Serve(tab::ServerSocket& server) {
+    try {
+        for (;;) {
+            auto client = server.accept();
+            ++accepted;
+            thread(Answer, move(client)).detach();
+        }
+    }
+    catch (const exception&) {
+        // The server is closed when exiting.
+    }
+}
+
+int main(int argc, char** argv) {
+    auto port = static_cast<port_t>(argc > 1 ? stoul(argv[1]) : 8083);
+    tab::ServerSocket server("127.0.0.1", port);
+    if (!server.bind() || !server.listen()) {
+        cout << "Cannot listen on port " << port << "." << endl;
+        return 1;
+    }
+    thread(Serve, ref(server)).detach();
+
+    string base = "http://127.0.0.1:" + to_string(port);
+    tab::HttpClient cli;
+    auto get = [&](const string& path) {
+        auto s = cli.target(tab::URL(base + path));
+        s.setWriter(tab::NullWriter());
+        s.setAutoJump(false);
+        return s.request().getCode();
+    };
+
+    cout << "Task 1: 20 sessions one by one." << endl;
+    for (int i = 0; i < 20; ++i)
+        get("/" + to_string(i));
+    cout << "Connections: " << accepted << " (expected 1)" << endl;
+    cout << "Idle: " << cli.getPool().idleCount() << " (expected 1)" << endl;
+
+    cout << "Task 2: the server closes an idle connection." << endl;
+    get("/drop");
+    this_thread::sleep_for(chrono::milliseconds(100));
+    cout << "Code: " << (int)get("/after-drop") << endl;
+    cout << "Connections: " << accepted << " (expected 2)" << endl;
+
+    cout << "Task 3: the connection of a session is closed." << endl;
+    {
+        auto s = cli.target(tab::URL(base + "/drop"));
+        s.setWriter(tab::NullWriter());
+        s.request();
+        this_thread::sleep_for(chrono::milliseconds(100));
+        // Sent again on a new connection.
+        s.setURI("/again");
+        cout << "Code: " << (int)s.request().getCode() << endl;
+    }
+    cout << "Connections: " << accepted << " (expected 3)" << endl;
+
+    cout << "Task 4: 3 sessions at the same time, 2 kept per host." << endl;
+    cli.getPool().setOptions({ 2, 60 });
+    {
+        auto a = cli.target(tab::URL(base + "/a"));
+        auto b = cli.target(tab::URL(base + "/b"));
+        auto c = cli.target(tab::URL(base + "/c"));
+        for (auto s : { &a, &b, &c }) {
+            s->setWriter(tab::NullWriter());
+            s->request();
+        }
+    }
+    cout << "Connections: " << accepted << " (expected 5)" << endl;
+    cout << "Idle: " << cli.getPool().idleCount() << " (expected 2)" << endl;
+
+    cout << "Task 5: idle timeout." << endl;
+    cli.getPool().setOptions({ 2, 0 });
+    cli.getPool().purge();
+    cout << "Idle: " << cli.getPool().idleCount() << " (expected 0)" << endl;
+    return 0;
+}
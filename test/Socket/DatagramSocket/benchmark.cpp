@@ -0,0 +1,104 @@
+/**
+ * @file benchmark.cpp
+ * @brief Compare the packet rate of sending and receiving datagrams one 
+ *        by one with the batch I/O (sendBatch() and recvBatch()).
+ *
+ * @note Usage: benchmark [packets] [size] [port]
+ * @note The one-by-one receiver calls recvfrom() directly, since
+ * @note DatagramSocket::recv() does not report the timeout.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EzNet/Socket/DatagramSocket.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+const int BATCH = 64;
+
+// Receive until no datagram arrives for 200 ms (SO_RCVTIMEO), and return
+// the number.
+long long Receive(tab::DatagramSocket& s, int size, bool batch) {
+    vector<char> buf(BATCH * size);
+    tab::Datagram packets[BATCH];
+    for (int i = 0; i < BATCH; ++i)
+        packets[i] = tab::Datagram(&buf[i * size], size);
+    long long got = 0;
+    for (;;) {
+        if (batch) {
+            int n = s.recvBatch(packets, BATCH);
+            if (n <= 0)
+                break;
+            got += n;
+        }
+        else {
+            sockaddr_storage from;
+            socklen_t len = sizeof(from);
+            if (recvfrom(s.get(), buf.data(), size, 0, 
+                         (sockaddr_t*)&from, &len) < 0)
+                break;
+            ++got;
+        }
+    }
+    return got;
+}
+
+void Run(bool batch, long long count, int size, port_t port) {
+    tab::DatagramSocket receiver;
+    int rcvbuf = 64 << 20;
+    receiver.setOpt(SOL_SOCKET, SO_RCVBUF, (const char*)&rcvbuf, 
+                    sizeof(rcvbuf));
+    timeval timeout{0, 200000};
+    receiver.setOpt(SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, 
+                    sizeof(timeout));
+    if (!receiver.bind("127.0.0.1", port)) {
+        printf("Cannot bind port %d.\n", port);
+        return;
+    }
+    atomic<long long> got(0);
+    thread t([&] { got = Receive(receiver, size, batch); });
+
+    tab::DatagramSocket sender;
+    tab::Address dest = receiver.getAddr();
+    vector<char> data(size, 'x');
+    tab::Datagram packets[BATCH];
+    for (auto& p : packets) {
+        p = tab::Datagram(data.data(), size, size);
+        p.setAddress(dest);
+    }
+
+    auto start = steady_clock::now();
+    for (long long sent = 0; sent < count;) {
+        if (batch) {
+            int n = sender.sendBatch(
+                packets, (int)min<long long>(BATCH, count - sent));
+            if (n > 0)
+                sent += n;
+        }
+        else {
+            sender.sendTo(dest, data.data(), size);
+            ++sent;
+        }
+    }
+    double s = duration<double>(steady_clock::now() - start).count();
+    t.join();
+    printf("%-10s sent %.2f Mpps, received %lld of %lld\n", 
+           batch ? "Batch:" : "One by one:", count / s / 1e6, 
+           (long long)got, count);
+}
+
+int main(int argc, char** argv) {
+    long long count = argc > 1 ? stoll(argv[1]) : 2000000;
+    int size = argc > 2 ? stoi(argv[2]) : 64;
+    auto port = static_cast<port_t>(argc > 3 ? stoul(argv[3]) : 8090);
+    Run(false, count, size, port);
+    Run(true, count, size, port);
+    return 0;
+}
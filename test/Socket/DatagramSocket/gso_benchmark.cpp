@@ -0,0 +1,118 @@
+/**
+ * @file gso_benchmark.cpp
+ * @brief Compare the throughput of sending datagrams one by one with UDP
+ *        GSO (sendSegments()), received with and without UDP GRO.
+ *
+ * @note Usage: gso_benchmark [MB] [segment size] [port]
+ * @note The sender is not paced, so a receiver slower than it drops
+ * @note datagrams.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "EzNet/Socket/DatagramSocket.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+const int    BATCH = 16;
+const size_t BUFFER_SIZE = 65536;
+
+struct Received {
+    long long bytes = 0;
+    long long datagrams = 0;
+    long long calls = 0;
+};
+
+// Receive until no datagram arrives for 200 ms (SO_RCVTIMEO).
+Received Receive(tab::DatagramSocket& s) {
+    vector<char> buf(BATCH * BUFFER_SIZE);
+    tab::Datagram packets[BATCH];
+    for (int i = 0; i < BATCH; ++i)
+        packets[i] = tab::Datagram(&buf[i * BUFFER_SIZE], BUFFER_SIZE);
+    Received ret;
+    for (int n; (n = s.recvBatch(packets, BATCH)) > 0;) {
+        ++ret.calls;
+        for (int i = 0; i < n; ++i) {
+            auto& p = packets[i];
+            ret.bytes += p.length;
+            ret.datagrams += p.segment_size == 0 ? 1 : 
+                (p.length + p.segment_size - 1) / p.segment_size;
+        }
+    }
+    return ret;
+}
+
+void Run(const char* name, bool gso, bool gro, long long total, 
+         size_t segment, port_t port) {
+    tab::DatagramSocket receiver;
+    int rcvbuf = 64 << 20;
+    receiver.setOpt(SOL_SOCKET, SO_RCVBUF, (const char*)&rcvbuf, 
+                    sizeof(rcvbuf));
+    timeval timeout{0, 200000};
+    receiver.setOpt(SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, 
+                    sizeof(timeout));
+    if (!receiver.bind("127.0.0.1", port)) {
+        printf("Cannot bind port %d.\n", port);
+        return;
+    }
+    if (gro && !receiver.enableGro())
+        printf("UDP GRO is not supported.\n");
+    Received got;
+    thread t([&] { got = Receive(receiver); });
+
+    tab::DatagramSocket sender;
+    tab::Address dest = receiver.getAddr();
+    // 64 segments are sent by each call.
+    vector<char> data(segment * 64, 'x');
+    auto start = steady_clock::now();
+    for (long long sent = 0; sent < total; sent += data.size()) {
+        if (gso)
+            sender.sendSegments(dest, data.data(), data.size(), segment);
+        else
+            for (size_t off = 0; off < data.size(); off += segment)
+                sender.sendTo(dest, data.data() + off, (int)segment);
+    }
+    double s = duration<double>(steady_clock::now() - start).count();
+    t.join();
+    printf("%-12s %6.2f Gbit/s sent, received %lld MB in %lld datagrams "
+           "by %lld calls\n", name, total * 8 / s / 1e9, got.bytes >> 20, 
+           got.datagrams, got.calls);
+}
+
+// An empty buffer sends nothing, and a segment larger than 65535 bytes is
+// rejected.
+void CheckArguments(port_t port) {
+    tab::DatagramSocket receiver;
+    if (!receiver.bind("127.0.0.1", port))
+        return;
+    tab::DatagramSocket sender;
+    char data[16] = {};
+    printf("Empty buffer: %lld bytes sent (expected 0).\n", 
+           sender.sendSegments(receiver.getAddr(), data, 0, 1200));
+    try {
+        sender.sendSegments(receiver.getAddr(), data, sizeof(data), 70000);
+        printf("Segment of 70000 bytes: accepted.\n");
+    }
+    catch (const invalid_argument&) {
+        printf("Segment of 70000 bytes: rejected.\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    long long mb = argc > 1 ? stoll(argv[1]) : 1024;
+    size_t segment = argc > 2 ? stoul(argv[2]) : 1200;
+    auto port = static_cast<port_t>(argc > 3 ? stoul(argv[3]) : 8091);
+    CheckArguments(port);
+    Run("One by one:", false, false, mb << 20, segment, port);
+    Run("GSO:", true, false, mb << 20, segment, port);
+    Run("GSO + GRO:", true, true, mb << 20, segment, port);
+    return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file ktls_benchmark.cpp
+ * @brief Compare the throughput of SecureSocket with and without kTLS on
+ *        loopback, by 'send()' and by 'sendFile()'.
+ *
+ * @note Usage: test-ktls [MB] [port]
+ * @note "cert.pem" and "key.pem" are needed, see resume.cpp.
+ * @note kTLS needs the "tls" module of the kernel ("modprobe tls"),
+ * @note without which OpenSSL encrypts in user space as usual.
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "EzNet.hpp"
+#include "EzNet/Socket/SecureSocket.hpp"
+
+using namespace std;
+using namespace std::chrono;
+using namespace tab;
+
+// Read all the data of each connection, then answer "done".
+void Serve(ServerSocket& server, SslContext& ctx) {
+    try {
+        for (;;) {
+            auto client = server.accept();
+            SSL* ssl = SSL_new(ctx.get());
+            SSL_set_fd(ssl, client.get());
+            if (SSL_accept(ssl) == 1) {
+                static char buf[1 << 16];
+                long long size = 0, got = 0;
+                SSL_read(ssl, &size, sizeof(size));
+                for (int n; got < size &&
+                            (n = SSL_read(ssl, buf, sizeof(buf))) > 0;)
+                    got += n;
+                SSL_write(ssl, "done", 4);
+            }
+            SSL_free(ssl);
+        }
+    }
+    catch (const exception&) {
+        // The server is closed when exiting.
+    }
+}
+
+void Run(const char* name, bool ktls, bool file, long long size,
+         port_t port) {
+    SslContext ctx;
+    ctx.enableKernelTls(ktls);
+    SecureSocket ss(ctx);
+    ss.connect(URL("https://127.0.0.1:" + to_string(port) + "/").getHost());
+
+    auto start = steady_clock::now();
+    ss.send((const char*)&size, sizeof(size));
+    if (file) {
+        int fd = open("ktls_benchmark.tmp", O_RDONLY);
+        ss.sendFile(fd, 0, size);
+        close(fd);
+    }
+    else {
+        static char buf[1 << 14];
+        for (long long sent = 0; sent < size; sent += sizeof(buf))
+            ss.send(buf, sizeof(buf));
+    }
+    char done[8]{};
+    ss.recv(done, sizeof(done));
+    double s = duration<double>(steady_clock::now() - start).count();
+    printf("%-16s kTLS send: %-3s  %8.1f MiB/s\n", name,
+           ss.kernelTlsSend() ? "yes" : "no", size / s / (1 << 20));
+}
+
+int main(int argc, char** argv) {
+    long long mb = argc > 1 ? stoll(argv[1]) : 1024;
+    auto port = static_cast<port_t>(argc > 2 ? stoul(argv[2]) : 8087);
+    long long size = mb << 20;
+
+    SslContext server_ctx;
+    server_ctx.setCertificateFile("cert.pem");
+    server_ctx.setPrivateKeyFile("key.pem");
+    if (!server_ctx.enableKernelTls())
+        cout << "kTLS is not supported by this build." << endl;
+
+    ServerSocket server("127.0.0.1", port);
+    if (!server.bind() || !server.listen()) {
+        cout << "Cannot listen on port " << port << "." << endl;
+        return 1;
+    }
+    thread(Serve, ref(server), ref(server_ctx)).detach();
+
+    FILE* fp = fopen("ktls_benchmark.tmp", "wb");
+    static char block[1 << 20];
+    for (long long i = 0; i < mb; ++i)
+        fwrite(block, 1, sizeof(block), fp);
+    fclose(fp);
+
+    cout << "Sending " << mb << " MiB." << endl;
+    Run("send()", false, false, size, port);
+    Run("send()", true, false, size, port);
+    Run("sendFile()", false, true, size, port);
+    Run("sendFile()", true, true, size, port);
+    remove("ktls_benchmark.tmp");
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file resume.cpp
+ * @brief Test the TLS session resumption of SecureSocket with a server
+ *        running in this program.
+ *
+ * @note Usage: test-resume [port]
+ * @note "cert.pem" and "key.pem" are needed, which can be made by:
+ * @note openssl req -x509 -newkey rsa:2048 -nodes -keyout key.pem
+ * @note     -out cert.pem -days 1 -subj /CN=localhost
+ *
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "EzNet.hpp"
+#include "EzNet/Socket/SecureSocket.hpp"
+
+using namespace std;
+using namespace tab;
+
+// Answer "pong" to each connection, so that the tickets of TLS 1.3, sent
+// after the handshake, are read by the client.
+void Serve(ServerSocket& server, SslContext& ctx) {
+    try {
+        for (;;) {
+            auto client = server.accept();
+            SSL* ssl = SSL_new(ctx.get());
+            SSL_set_fd(ssl, client.get());
+            char buf[16];
+            if (SSL_accept(ssl) == 1 && SSL_read(ssl, buf, sizeof(buf)) > 0)
+                SSL_write(ssl, "pong", 4);
+            SSL_shutdown(ssl);
+            SSL_free(ssl);
+        }
+    }
+    catch (const exception&) {
+        // The server is closed when exiting.
+    }
+}
+
+int main(int argc, char** argv) {
+    auto port = static_cast<port_t>(argc > 1 ? stoul(argv[1]) : 8086);
+    SslContext server_ctx;
+    server_ctx.setCertificateFile("cert.pem");
+    server_ctx.setPrivateKeyFile("key.pem");
+    server_ctx.enableServerSessionCache();
+    server_ctx.setTicketKeys(SslContext::GenerateTicketKeys());
+
+    ServerSocket server("127.0.0.1", port);
+    if (!server.bind() || !server.listen()) {
+        cout << "Cannot listen on port " << port << "." << endl;
+        return 1;
+    }
+    thread(Serve, ref(server), ref(server_ctx)).detach();
+
+    SslContext ctx;
+    auto host = URL("https://127.0.0.1:" + to_string(port) + "/").getHost();
+    for (int i = 0; i < 5; ++i) {
+        SecureSocket ss(ctx);
+        ss.setHostName("localhost");
+        ss.connect(host);
+        ss.send("ping");
+        char buf[16]{};
+        ss.recv(buf, sizeof(buf));
+        cout << "Connection " << i << ": " << buf << ", "
+             << (ss.sessionReused() ? "resumed" : "full handshake") << endl;
+    }
+
+    auto stats = ctx.getHandshakeStats();
+    cout << "Client: " << stats.client_full << " full, "
+         << stats.client_resumed << " resumed (expected 1 and 4)" << endl;
+    stats = server_ctx.getHandshakeStats();
+    cout << "Server: " << stats.server_full << " full, "
+         << stats.server_resumed << " resumed" << endl;
+    return 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file main.cpp
+ * @brief Test the timeouts of the connections of TcpServer, and the timers
+ *        of the handler thread.
+ *
+ * @note Usage: test-timeout [port] [uring]
+ * @note The server echoes the lines received and keeps the connections,
+ *       which are closed after 1 second of idle (or of receiving a line).
+ *       An idle client and a slow one are expected to be closed in about
+ *       1 second, and an active one is expected to be kept.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "EzNet.hpp"
+#include "EzNet/Socket/TcpServer.hpp"
+#include "EzNet/Utility/Event/TimerWheel.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+tab::Address target;
+atomic<int> ticks{0};
+tab::TimerWheel::Timer ticker;
+
+long long Elapsed(steady_clock::time_point start) {
+    return duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+// Connects and sends nothing.
+void Idle(long long& closed_ms) {
+    tab::StreamSocket cli(AF_INET);
+    cli.connect(target);
+    auto start = steady_clock::now();
+    char buf[64];
+    while (cli.recv(buf, sizeof(buf)) > 0) { }
+    closed_ms = Elapsed(start);
+}
+
+// Sends a byte every 200 ms, never finishing the line.
+void Slow(long long& closed_ms) {
+    tab::StreamSocket cli(AF_INET);
+    cli.connect(target);
+    auto start = steady_clock::now();
+    atomic<bool> closed{false};
+    thread trickle([&] {
+        for (int i = 0; i < 50 && !closed; ++i) {
+            if (cli.send("a", 1) <= 0)
+                break;
+            this_thread::sleep_for(milliseconds(200));
+        }
+    });
+    char buf[64];
+    while (cli.recv(buf, sizeof(buf)) > 0) { }
+    closed_ms = Elapsed(start);
+    closed = true;
+    trickle.join();
+}
+
+// Sends a line every 400 ms, for longer than the timeouts.
+void Active(int& echoed) {
+    tab::StreamSocket cli(AF_INET);
+    cli.connect(target);
+    char buf[64];
+    for (int i = 0; i < 6; ++i) {
+        cli.send("hello\n");
+        if (cli.recv(buf, sizeof(buf)) <= 0)
+            break;
+        ++echoed;
+        this_thread::sleep_for(milliseconds(400));
+    }
+}
+
+int main(int argc, char** argv) {
+    auto port = static_cast<port_t>(argc > 1 ? stoul(argv[1]) : 8095);
+    tab::TcpServer server;
+    auto& cfg = server.configTCP();
+    cfg.listen_address.set(
+        tab::URL("http://127.0.0.1:" + to_string(port) + "/").getHost()
+                                                              .getAddr());
+    cfg.connection_timeout_seconds = 1;
+    if (argc > 2)
+        cfg.io_backend = tab::TcpServer::TcpConfig::IOBackend::IO_URING;
+    target = cfg.listen_address.getAddr();
+
+    server.registerEvent<tab::ConnectionAcceptedEvent>(
+        [](tab::ConnectionAcceptedEvent& e) {
+            // Ticks 3 times every 300 ms, in the handler thread.
+            if (!ticker.callback) {
+                auto& timers = e.timers();
+                ticker.callback = [&timers] {
+                    if (++ticks < 3)
+                        timers.arm(ticker, 300);
+                };
+                timers.arm(ticker, 300);
+            }
+            e.setNextOperation(tab::TcpServerEvent::OP_READ);
+        });
+    server.registerEvent<tab::DataReceivedEvent>(
+        [](tab::DataReceivedEvent& e) {
+            auto size = e.getContentSize();
+            if (size > 0 && e.getBuffer()[size - 1] == '\n')
+                e.setNextOperation(tab::TcpServerEvent::OP_WRITE);
+            else
+                e.setNextOperation(tab::TcpServerEvent::OP_READ);
+        });
+    server.registerEvent<tab::DataSentEvent>([](tab::DataSentEvent& e) {
+        e.setNextOperation(tab::TcpServerEvent::OP_READ);
+    });
+    server.start();
+
+    long long idle_ms = -1, slow_ms = -1;
+    int echoed = 0;
+    thread idle(Idle, ref(idle_ms));
+    thread slow(Slow, ref(slow_ms));
+    thread active(Active, ref(echoed));
+    idle.join();
+    slow.join();
+    active.join();
+    server.stop();
+
+    cout << "Idle client closed after " << idle_ms << " ms." << endl;
+    cout << "Slow client closed after " << slow_ms << " ms." << endl;
+    cout << "Active client: " << echoed << " of 6 lines echoed." << endl;
+    cout << "Timer ticks: " << ticks << " of 3." << endl;
+    return 0;
+}
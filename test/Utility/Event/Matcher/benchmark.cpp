@@ -0,0 +1,71 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "EzNet/Utility/Event/EventMatcher.hpp"
+#include "EzNet/Utility/Event/StaticEventMatcher.hpp"
+
+using namespace std;
+using namespace std::chrono;
+using namespace tab;
+
+class EventA : public Event {
+public:
+    EventA(int v) : value_(v) {}
+
+    constexpr static event_type_id_t GetEventTypeID() {
+        return 1;
+    }
+
+    int value_;
+};
+
+class EventB : public Event {
+public:
+    constexpr static event_type_id_t GetEventTypeID() {
+        return 2;
+    }
+};
+
+static unsigned long long sum = 0;
+
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void Handler(EventA& e) {
+    sum += e.value_;
+}
+
+template <typename Func>
+void Measure(const char* name, size_t times, Func f) {
+    sum = 0;
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < times; ++i) {
+        EventA e(static_cast<int>(i & 0xff));
+        f(e);
+    }
+    auto stop = steady_clock::now();
+    double ns = duration_cast<nanoseconds>(stop - start).count();
+    cout << name << ": " << ns / times << " ns per event "
+         << "(checksum " << sum << ")" << endl;
+}
+
+int main(int argc, char** argv) {
+    size_t times = 100000000;
+    if (argc > 1)
+        times = stoull(argv[1]);
+    cout << "Dispatch " << times << " events." << endl;
+
+    EventMatcher em;
+    em.set<EventA>(Handler);
+    em.set<EventB>([](EventB&) {});
+
+    StaticEventMatcher<EventA, EventB> sem;
+    sem.set<EventA>(Handler);
+    sem.set<EventB>([](EventB&) {});
+
+    Measure("Direct call        ", times, [](EventA& e) { Handler(e); });
+    Measure("StaticEventMatcher ", times, [&](EventA& e) { sem.call(e); });
+    Measure("EventMatcher       ", times, [&](EventA& e) { em.call(e); });
+    return 0;
+}